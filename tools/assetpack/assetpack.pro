@@ -0,0 +1,24 @@
+# Offline asset packer: writes assets.pak for the game in ../../try
+QT += core gui concurrent
+CONFIG += console
+CONFIG -= app_bundle
+
+GAME = $$PWD/../../try
+INCLUDEPATH += $$GAME
+
+SOURCES += \
+    main.cpp \
+    $$GAME/assetpack.cpp \
+    $$GAME/chipsynth.cpp \
+    $$GAME/crtfilter.cpp \
+    $$GAME/framerenderer.cpp \
+    $$GAME/levelcache.cpp \
+    $$GAME/levelpack.cpp
+
+HEADERS += \
+    $$GAME/assetpack.h \
+    $$GAME/chipsynth.h \
+    $$GAME/crtfilter.h \
+    $$GAME/framerenderer.h \
+    $$GAME/levelcache.h \
+    $$GAME/levelpack.h
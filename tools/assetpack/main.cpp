@@ -0,0 +1,93 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+
+#include "assetpack.h"
+#include "chipsynth.h"
+#include "framerenderer.h"
+
+// ==============================
+// 📦 ASSET PACKER
+// ==============================
+
+// Converts everything the game would otherwise build at startup into
+// assets.pak: effect PCM at the usual device rates, sprite tiles for
+// every cell size the window is likely to use, and optionally the menu
+// font.
+//
+//   assetpack [--font PressStart2P.ttf] out/assets.pak
+
+namespace {
+
+QList<int> parseInts(const QString &csv)
+{
+    QList<int> out;
+    for (const QString &part : csv.split(',', Qt::SkipEmptyParts))
+        if (const int v = part.trimmed().toInt(); v > 0) out.append(v);
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Packs pre-converted game assets into one mappable file.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "Archive to write, usually assets.pak next to the game.");
+    QCommandLineOption fontOpt("font", "TTF/OTF to bundle as the menu font.", "file");
+    QCommandLineOption ratesOpt("rates", "Sample rates to bake effects at.", "list", "44100,48000");
+    QCommandLineOption tilesOpt("tile-sizes", "Cell size range in device pixels.", "min-max", "8-64");
+    parser.addOptions({ fontOpt, ratesOpt, tilesOpt });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    AssetPackWriter pack;
+
+    // ----- Effects: rendered through the same synth the game falls back to -----
+    const struct { quint32 id; const ChipSong &song; } sfx[] = {
+        { AssetIds::SfxEat, ChipSongs::eat() },
+        { AssetIds::SfxDeath, ChipSongs::death() },
+        { AssetIds::SfxWin, ChipSongs::win() },
+    };
+    for (int rate : parseInts(parser.value(ratesOpt))) {
+        for (const auto &s : sfx) {
+            const QVector<qint16> pcm = ChipPlayer::renderClip(s.song, rate);
+            pack.add(assetVariant(s.id, quint32(rate)), AssetType::Pcm16Mono,
+                     QByteArray(reinterpret_cast<const char *>(pcm.constData()),
+                                pcm.size() * sizeof(qint16)),
+                     quint32(rate));
+        }
+    }
+
+    // ----- Sprite tiles, one entry per cell size -----
+    const QStringList range = parser.value(tilesOpt).split('-');
+    const int minCs = qMax(1, range.value(0).toInt());
+    const int maxCs = qMax(minCs, range.value(1, range.value(0)).toInt());
+    for (int cs = minCs; cs <= maxCs; ++cs)
+        pack.add(assetVariant(AssetIds::Tiles, quint32(cs)), AssetType::Tiles8,
+                 FrameRenderer::rasterizeTiles(cs), quint32(cs), FrameRenderer::kTileCount);
+
+    // ----- Menu font -----
+    if (parser.isSet(fontOpt)) {
+        QFile f(parser.value(fontOpt));
+        if (!f.open(QIODevice::ReadOnly)) {
+            err << "assetpack: cannot read " << f.fileName() << "\n";
+            return 1;
+        }
+        pack.add(AssetIds::FontRetro, AssetType::Font, f.readAll());
+    }
+
+    QString error;
+    if (!pack.write(parser.positionalArguments().first(), &error)) {
+        err << "assetpack: " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
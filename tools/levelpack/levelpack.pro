@@ -0,0 +1,25 @@
+# Offline level packer: writes levels.pak for the game in ../../try
+QT += core gui concurrent
+CONFIG += console
+CONFIG -= app_bundle
+
+GAME = $$PWD/../../try
+INCLUDEPATH += $$GAME
+
+# builtinlevels.cpp bakes the built-in levels at compile time
+msvc: QMAKE_CXXFLAGS += /constexpr:steps10000000
+clang: QMAKE_CXXFLAGS += -fconstexpr-steps=10000000
+
+SOURCES += \
+    main.cpp \
+    $$GAME/builtinlevels.cpp \
+    $$GAME/levelcompiler.cpp \
+    $$GAME/levelpack.cpp \
+    $$GAME/mazegenerator.cpp
+
+HEADERS += \
+    $$GAME/builtinlevels.h \
+    $$GAME/gametypes.h \
+    $$GAME/levelcompiler.h \
+    $$GAME/levelpack.h \
+    $$GAME/mazegenerator.h
@@ -0,0 +1,160 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
+#include <atomic>
+
+#include "builtinlevels.h"
+#include "levelcompiler.h"
+#include "levelpack.h"
+#include "mazegenerator.h"
+
+// ==============================
+// 🗺 LEVEL COMPILER / PACKER
+// ==============================
+
+// Compiles ASCII maps (format in levelcompiler.h) into levels.pak, with
+// reachability, pellets, the junction graph and landmark tables baked in
+// so the game does no analysis at load. Without maps the built-in levels
+// are packed instead, unless --generate asks for procedural ones.
+//
+//   levelpack [--landmarks 4] out/levels.pak [maps.txt ...]
+//   levelpack --generate 1000 [--style braided] [--seed 1] [--size 25x25]
+//             [--enemies 4] [--difficulty 0-100] out/levels.pak
+//   levelpack --generate 1000000 --bench
+//
+// --bench only generates and validates, in parallel, and prints the rate.
+
+namespace {
+
+// Generate-and-validate rate alone, nothing compiled or kept
+void bench(quint64 seed, int count, const MazeGenerator::Options &options, QTextStream &out)
+{
+    constexpr int kChunk = 1024;
+    QVector<int> chunks;
+    for (int first = 0; first < count; first += kChunk)
+        chunks.append(first);
+
+    std::atomic<int> failed{0};
+    std::atomic<qint64> difficulty{0};
+    QElapsedTimer clock;
+    clock.start();
+    QtConcurrent::blockingMap(chunks, [&](int first) {
+        MazeGenerator::Stats stats;
+        int misses = 0;
+        qint64 sum = 0;
+        for (int i = first; i < qMin(count, first + kChunk); ++i) {
+            if (MazeGenerator::generate(seed, quint64(i), options, nullptr, &stats))
+                sum += stats.difficulty;
+            else
+                ++misses;
+        }
+        failed += misses;
+        difficulty += sum;
+    });
+    const double secs = qMax<qint64>(1, clock.nsecsElapsed()) / 1e9;
+    const int bad = failed, made = count - bad;
+    out << "levelpack: " << made << " valid " << options.cols << "x" << options.rows << " "
+        << MazeGenerator::styleName(options.style) << " levels in " << QString::number(secs * 1000, 'f', 1)
+        << " ms, " << qRound64(count / secs) << " levels/s, " << bad << " failed, mean difficulty "
+        << (made > 0 ? difficulty.load() / made : 0) << "\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Packs game levels into one mappable file.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "Pack to write, usually levels.pak next to the game.");
+    parser.addPositionalArgument("maps", "ASCII map files, several levels each.", "[maps...]");
+    QCommandLineOption landmarksOpt("landmarks", "Distance tables per level for the A* heuristic.",
+                                    "count", QString::number(LevelCompiler::kDefaultLandmarks));
+    parser.addOption(landmarksOpt);
+    QCommandLineOption generateOpt("generate", "Procedural levels instead of maps.", "count");
+    QCommandLineOption styleOpt("style", "backtracker, braided or rooms.", "style", "braided");
+    QCommandLineOption seedOpt("seed", "Same seed, same levels.", "seed", "1");
+    QCommandLineOption sizeOpt("size", "Level size in cells.", "WxH", "25x25");
+    QCommandLineOption enemiesOpt("enemies", "Enemies per generated level.", "count", "4");
+    QCommandLineOption difficultyOpt("difficulty", "Keep only levels scoring in this range.", "min-max", "0-100");
+    QCommandLineOption benchOpt("bench", "Only time generation and validation; writes nothing.");
+    parser.addOptions({ generateOpt, styleOpt, seedOpt, sizeOpt, enemiesOpt, difficultyOpt, benchOpt });
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const bool benchOnly = parser.isSet(benchOpt);
+    if (args.isEmpty() && !benchOnly)
+        parser.showHelp(1);
+
+    const int generateCount = parser.value(generateOpt).toInt();
+    MazeGenerator::Options gen;
+    const QStringList size = parser.value(sizeOpt).split('x');
+    const QStringList range = parser.value(difficultyOpt).split('-');
+    if (!MazeGenerator::parseStyle(parser.value(styleOpt), &gen.style) || size.size() != 2
+        || range.size() != 2 || (parser.isSet(generateOpt) && generateCount <= 0)
+        || (benchOnly && !parser.isSet(generateOpt))) {
+        err << "levelpack: bad --generate, --style, --size, --difficulty or --bench\n";
+        return 1;
+    }
+    gen.cols = size[0].toInt();
+    gen.rows = size[1].toInt();
+    gen.enemies = qBound(0, parser.value(enemiesOpt).toInt(), 64);
+    gen.minDifficulty = range[0].toInt();
+    gen.maxDifficulty = range[1].toInt();
+    const quint64 seed = parser.value(seedOpt).toULongLong();
+
+    if (benchOnly) {
+        QTextStream out(stdout);
+        bench(seed, generateCount, gen, out);
+        return 0;
+    }
+
+    QVector<LevelData> levels;
+    for (const QString &path : args.mid(1)) {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            err << "levelpack: cannot read " << path << "\n";
+            return 1;
+        }
+        QString error;
+        if (!LevelCompiler::parse(QString::fromUtf8(f.readAll()), &levels, &error)) {
+            err << "levelpack: " << path << ": " << error << "\n";
+            return 1;
+        }
+    }
+    if (args.size() == 1 && generateCount == 0)
+        for (int i = 0; i < BuiltinLevels::count(); ++i)
+            levels.append(BuiltinLevels::level(i));
+
+    const int landmarks = qBound(0, parser.value(landmarksOpt).toInt(), 64);
+    for (LevelData &l : levels)
+        LevelCompiler::compile(l, landmarks);
+
+    // Made and compiled across all cores, still in index order
+    if (generateCount > 0) {
+        int failed = 0;
+        levels += MazeGenerator::generateMany(seed, generateCount, gen, landmarks, &failed);
+        if (failed > 0)
+            err << "levelpack: warning: " << failed << " levels did not validate and were skipped\n";
+    }
+
+    LevelPackWriter pack;
+    for (const LevelData &l : levels) {
+        if (l.food.count() == 0)
+            err << "levelpack: warning: " << l.name << " has no reachable pellets\n";
+        pack.add(l);
+    }
+
+    QString error;
+    if (!pack.write(args.first(), &error)) {
+        err << "levelpack: " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QTimer>
+
+#include "framerenderer.h"
+#include "gamesimulation.h"
+#include "levellibrary.h"
+
+// ==============================
+// ⏱ MEGA-MAZE BENCHMARK
+// ==============================
+
+// Plays generated boards of several sizes the way the game does and
+// reports, per size:
+//   load     generating and compiling the board (again from --cache, if
+//            given, once the first copy is dropped)
+//   memory   the whole board as a shared level template, and what one
+//            session would add on top of it
+//   start    opening the streamed board, writing its world file first if
+//            there is none yet, and how much of that blocked the
+//            simulation thread (the rest runs on the global pool)
+//   tick     GameSimulation ticks at the bot rate while a random walker
+//            steers Pac-Man, and the enemy AI share of them
+//   world    the streamed board the session actually played: chunks in
+//            memory, loads, evictions and misses (wanted, not in yet).
+//            The cap is a quarter of the board by default (never less
+//            than the streamed area), so eviction is exercised, and the
+//            run fails (exit code 1) if the chunks ever stayed over it
+//            after a tick.
+//   frame    FrameRenderer through a 1280x720 camera at 16 px cells
+//
+//   mazebench [--sizes 25,256,1024,2048,4096] [--seconds 2] [--cache dir]
+//             [--cap MB]
+
+namespace {
+
+const QSize kViewport(1280, 720);
+constexpr int kCellSize = 16;
+constexpr int kFrames = 120;
+
+double mb(qint64 bytes) { return bytes / (1024.0 * 1024.0); }
+
+qint64 templateBytes(const LevelData &l)
+{
+    return l.walls.data().size() + l.reachable.data().size() + l.food.data().size()
+        + l.graph.nodeData.size() + l.graph.edgeData.size() + l.graph.cellData.size()
+        + l.landmarks.data.size() + l.enemies.size() * qint64(sizeof(Enemy));
+}
+
+// Pellets once the first is eaten, enemies, and the same again in a snapshot
+qint64 sessionBytes(const LevelData &l)
+{
+    return 2 * (l.food.data().size() + l.enemies.size() * qint64(sizeof(Enemy) + sizeof(QPoint)));
+}
+
+// Holds a random arrow for a random 50-300 ms, like a very bad player
+void steer(GameSimulation &sim, QTimer &timer)
+{
+    static const qint8 dirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    static int held = -1;
+    if (held >= 0)
+        sim.postInput(InputEvent{ InputEvent::Release, dirs[held][0], dirs[held][1], monotonicNs() });
+    held = int(monotonicNs() / 1000) & 3;
+    sim.postInput(InputEvent{ InputEvent::Press, dirs[held][0], dirs[held][1], monotonicNs() });
+    timer.start(50 + int(monotonicNs() / 1000 % 250));
+}
+
+TimingHistogram renderFrames(GameSimulation &sim)
+{
+    TimingHistogram frames;
+    TripleBuffer<GameSnapshot> &snapshots = sim.snapshots();
+    snapshots.update();
+    const GameSnapshot &s = snapshots.read();
+
+    RenderScene scene;
+    scene.rows = s.rows;
+    scene.cols = s.cols;
+    scene.cellSize = qMax(kCellSize, qMin(kViewport.width() / s.cols, kViewport.height() / s.rows));
+    scene.viewport = kViewport;
+    scene.maze = &s.maze;
+    scene.food = &s.food;
+    scene.gridOrigin = s.gridOrigin;
+    scene.enemies = &s.enemies;
+    scene.enemiesFrom = &s.enemiesFrom;
+    scene.playerX = s.playerX;
+    scene.playerY = s.playerY;
+    scene.playerFromX = s.playerFromX;
+    scene.playerFromY = s.playerFromY;
+    scene.playerDirX = s.playerDirX;
+    scene.playerDirY = s.playerDirY;
+
+    // The first frame builds the wall layer, if the board gets one
+    FrameRenderer raster;
+    QImage frame;
+    QElapsedTimer clock;
+    for (int i = 0; i <= kFrames; ++i) {
+        scene.t = float(i % 8) / 8.0f;
+        scene.mouthOpen = i & 1;
+        clock.start();
+        raster.render(scene, frame);
+        if (i > 0)
+            frames.record(clock.nsecsElapsed());
+    }
+    return frames;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load, memory, tick and frame cost of generated boards.");
+    parser.addHelpOption();
+    QCommandLineOption sizesOpt("sizes", "Board sides to run.", "list", "25,256,1024,2048,4096");
+    QCommandLineOption secondsOpt("seconds", "Play time per size.", "seconds", "2");
+    QCommandLineOption cacheOpt("cache", "Level cache directory; adds a cached reload.", "dir");
+    QCommandLineOption capOpt("cap", "Memory cap for streamed chunks; a quarter of the board if unset.", "MB");
+    parser.addOptions({ sizesOpt, secondsOpt, cacheOpt, capOpt });
+    parser.process(app);
+
+    const int seconds = qBound(1, parser.value(secondsOpt).toInt(), 600);
+    bool failed = false;
+    LevelLibrary library(QString(), parser.value(cacheOpt));
+
+    for (const QString &item : parser.value(sizesOpt).split(',', Qt::SkipEmptyParts)) {
+        const int side = qBound(25, item.toInt(), LevelPack::kMaxSide);
+        out << side << "x" << side << "\n";
+
+        QElapsedTimer clock;
+        clock.start();
+        LevelTemplate level = library.megaMaze(side);
+        out << "  load      " << QString::number(clock.nsecsElapsed() / 1e6, 'f', 1) << " ms";
+        if (library.cache()) {
+            level.reset();
+            clock.start();
+            level = library.megaMaze(side);
+            out << ", " << QString::number(clock.nsecsElapsed() / 1e6, 'f', 1) << " ms cached";
+        }
+        out << "\n";
+        out << "  memory    " << QString::number(mb(templateBytes(*level)), 'f', 1) << " MB level, "
+            << QString::number(mb(sessionBytes(*level)), 'f', 1) << " MB per session, "
+            << level->enemies.size() << " enemies\n";
+        out.flush();
+
+        GameSimulation sim(library);
+        sim.setTickRate(GameSimulation::kMaxTickHz);
+        const qint64 chunks = qint64((side + ChunkedWorld::kChunkSide - 1) / ChunkedWorld::kChunkSide);
+        const qint64 streamed = qint64(GameSimulation::kStreamChunks) * GameSimulation::kStreamChunks;
+        const qint64 cap = parser.isSet(capOpt)
+            ? qint64(parser.value(capOpt).toInt()) << 20
+            : qMax(chunks * chunks / 4, streamed) * ChunkedWorld::kChunkBytes;
+        sim.setWorldMemoryCap(cap);
+        QEventLoop starting;
+        bool started = false, settled = false;
+        QObject::connect(&sim, &GameSimulation::levelStarted, &starting, [&]() {
+            started = settled = true;
+            starting.quit();
+        });
+        QObject::connect(&sim, &GameSimulation::levelFailed, &starting, [&]() {
+            settled = true;
+            starting.quit();
+        });
+        clock.start();
+        sim.startMegaMaze(side);
+        const qint64 blockedNs = clock.nsecsElapsed();
+        if (!settled)
+            starting.exec();
+        out << "  start     " << QString::number(clock.nsecsElapsed() / 1e6, 'f', 1)
+            << " ms to open the streamed board, "
+            << QString::number(blockedNs / 1e6, 'f', 1) << " ms of it on the simulation thread\n";
+        if (!started) {
+            out << "  FAIL: the streamed board could not be made\n";
+            failed = true;
+            continue;
+        }
+
+        QTimer steering;
+        steering.setSingleShot(true);
+        QObject::connect(&steering, &QTimer::timeout, [&]() { steer(sim, steering); });
+        steer(sim, steering);
+
+        QEventLoop loop;
+        QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+        QObject::connect(&sim, &GameSimulation::gameOver, &loop, &QEventLoop::quit);
+        QObject::connect(&sim, &GameSimulation::levelCleared, &loop, &QEventLoop::quit);
+        loop.exec();
+        sim.stop();
+        steering.stop();
+
+        const GameSimulation::TickStats ticks = sim.tickStats();
+        out << "  tick      " << ticks.duration.summary() << "\n";
+        out << "  enemy AI  " << ticks.ai.summary() << "\n";
+        const ChunkedWorld::Stats &world = ticks.world;
+        out << "  world     " << world.resident << " chunks, "
+            << QString::number(mb(world.bytes), 'f', 1) << " MB, "
+            << world.loads << " loads, " << world.evictions << " evictions, "
+            << world.misses << " misses, cap "
+            << QString::number(mb(cap), 'f', 2) << " MB\n";
+        if (world.peakBytes > cap) {
+            out << "  FAIL: " << QString::number(mb(world.peakBytes), 'f', 2) << " MB resident, cap "
+                << QString::number(mb(cap), 'f', 2) << " MB\n";
+            failed = true;
+        }
+        out << "  frame     " << renderFrames(sim).summary() << "\n";
+        out.flush();
+    }
+    return failed ? 1 : 0;
+}
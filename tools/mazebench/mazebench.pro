@@ -0,0 +1,49 @@
+# Mega-maze benchmark: load, memory, tick and frame cost per board size
+QT += core gui concurrent multimedia
+CONFIG += console
+CONFIG -= app_bundle
+
+GAME = $$PWD/../../try
+INCLUDEPATH += $$GAME
+
+# builtinlevels.cpp bakes the built-in levels at compile time
+msvc: QMAKE_CXXFLAGS += /constexpr:steps10000000
+clang: QMAKE_CXXFLAGS += -fconstexpr-steps=10000000
+
+SOURCES += \
+    main.cpp \
+    $$GAME/assetpack.cpp \
+    $$GAME/audiomixer.cpp \
+    $$GAME/builtinlevels.cpp \
+    $$GAME/chunkedworld.cpp \
+    $$GAME/chipsynth.cpp \
+    $$GAME/crtfilter.cpp \
+    $$GAME/framerenderer.cpp \
+    $$GAME/framescheduler.cpp \
+    $$GAME/gamesimulation.cpp \
+    $$GAME/levelcache.cpp \
+    $$GAME/levelcompiler.cpp \
+    $$GAME/levellibrary.cpp \
+    $$GAME/levelpack.cpp \
+    $$GAME/mazegenerator.cpp \
+    $$GAME/mazerouter.cpp
+
+HEADERS += \
+    $$GAME/assetpack.h \
+    $$GAME/audiomixer.h \
+    $$GAME/builtinlevels.h \
+    $$GAME/chunkedworld.h \
+    $$GAME/chipsynth.h \
+    $$GAME/crtfilter.h \
+    $$GAME/framerenderer.h \
+    $$GAME/framescheduler.h \
+    $$GAME/gamesimulation.h \
+    $$GAME/gametypes.h \
+    $$GAME/levelcache.h \
+    $$GAME/levelcompiler.h \
+    $$GAME/levellibrary.h \
+    $$GAME/levelpack.h \
+    $$GAME/mazegenerator.h \
+    $$GAME/mazerouter.h \
+    $$GAME/spscring.h \
+    $$GAME/triplebuffer.h
@@ -0,0 +1,94 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThread>
+
+#include "audiomixer.h"
+
+// ==============================
+// 🔊 MIXER LATENCY CHECK
+// ==============================
+
+// Plays an effect at a random point of every buffer and pulls the mix
+// through render() on the clock, the way a null sink would, then reads
+// play() to first sample back from latencyStats(). With no device there
+// is no queued output on top, so each effect should be heard by the next
+// buffer: the check fails (exit code 1) if any play() went unheard or p99
+// is past --limit-ms.
+//
+//   mixerlatency [--buffer-ms 10] [--seconds 2] [--limit-ms 2 x buffer]
+
+namespace {
+
+// A click shorter than any buffer, so every voice is done after one mix
+constexpr int kClipFrames = 64;
+
+void sleepUntil(const QElapsedTimer &clock, qint64 ns)
+{
+    const qint64 left = ns - clock.nsecsElapsed();
+    if (left > 0)
+        QThread::usleep(quint64(left / 1000));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Effect latency through AudioMixer without an audio device.");
+    parser.addHelpOption();
+    QCommandLineOption bufferOpt("buffer-ms", "Null sink buffer.", "ms", "10");
+    QCommandLineOption secondsOpt("seconds", "Run time.", "seconds", "2");
+    QCommandLineOption limitOpt("limit-ms", "Highest p99 that passes; twice the buffer if unset.", "ms");
+    parser.addOptions({ bufferOpt, secondsOpt, limitOpt });
+    parser.process(app);
+
+    const int bufferMs = qBound(1, parser.value(bufferOpt).toInt(), 500);
+    const int seconds = qBound(1, parser.value(secondsOpt).toInt(), 600);
+    const double limitMs = parser.isSet(limitOpt) ? parser.value(limitOpt).toDouble() : 2.0 * bufferMs;
+
+    AudioMixer mixer;
+    QVector<qint16> click(kClipFrames);
+    for (int i = 0; i < kClipFrames; ++i)
+        click[i] = qint16(i & 8 ? 8000 : -8000);
+    mixer.loadPcm(AudioMixer::Eat, click.constData(), kClipFrames);
+
+    const int frames = mixer.sampleRate() * bufferMs / 1000;
+    const qint64 periodNs = qint64(bufferMs) * 1000000;
+    QVector<qint16> buffer(frames * AudioMixer::kChannels);
+
+    QRandomGenerator rng(1);
+    QElapsedTimer clock;
+    clock.start();
+    qint64 plays = 0;
+    for (qint64 due = periodNs; due <= qint64(seconds) * 1000000000; due += periodNs) {
+        sleepUntil(clock, due - periodNs + qint64(rng.bounded(double(periodNs))));
+        mixer.play(AudioMixer::Eat, 0.5f, float(rng.bounded(2.0) - 1.0));
+        ++plays;
+        sleepUntil(clock, due);
+        mixer.render(buffer.data(), frames);
+    }
+
+    const TimingHistogram latency = mixer.latencyStats();
+    out << "buffer     " << frames << " frames at " << mixer.sampleRate() << " Hz\n";
+    out << "latency    " << latency.summary() << "\n";
+    out << "mix cost   " << mixer.mixCostStats().summary() << "\n";
+
+    bool ok = true;
+    if (latency.count() != plays) {
+        out << "FAIL: " << plays - latency.count() << " of " << plays << " effects never started\n";
+        ok = false;
+    }
+    if (latency.percentile(0.99) > qint64(limitMs * 1e6)) {
+        out << "FAIL: p99 over the " << limitMs << " ms limit\n";
+        ok = false;
+    }
+    if (ok)
+        out << "ok\n";
+    return ok ? 0 : 1;
+}
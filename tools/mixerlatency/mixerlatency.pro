@@ -0,0 +1,18 @@
+# Effect latency check: AudioMixer on a null sink, fails past a limit
+QT += core multimedia
+CONFIG += console
+CONFIG -= app_bundle
+
+GAME = $$PWD/../../try
+INCLUDEPATH += $$GAME
+
+SOURCES += \
+    main.cpp \
+    $$GAME/audiomixer.cpp \
+    $$GAME/chipsynth.cpp \
+    $$GAME/framescheduler.cpp
+
+HEADERS += \
+    $$GAME/audiomixer.h \
+    $$GAME/chipsynth.h \
+    $$GAME/framescheduler.h
@@ -0,0 +1,160 @@
+#include "assetpack.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN,
+              "assets.pak payloads are used in place and stored little endian");
+
+namespace {
+
+constexpr char kMagic[4] = { 'P', 'M', 'A', 'K' };
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderSize = 16;
+constexpr int kAlign = 64;
+
+} // namespace
+
+struct AssetArchive::Entry {
+    quint32 id;
+    quint32 type;
+    quint64 offset;
+    quint64 size;
+    quint32 param0;
+    quint32 param1;
+};
+
+AssetArchive::~AssetArchive()
+{
+    close();
+}
+
+bool AssetArchive::open(const QString &path)
+{
+    static_assert(sizeof(Entry) == 32, "entry layout is part of the file format");
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    length = file.size();
+    base = length >= kHeaderSize ? file.map(0, length) : nullptr;
+    if (!base) {
+        close();
+        return false;
+    }
+
+    const quint16 version = qFromLittleEndian<quint16>(base + 4);
+    const quint32 n = qFromLittleEndian<quint32>(base + 8);
+    if (std::memcmp(base, kMagic, 4) != 0 || version != kVersion
+        || n > quint64(length - kHeaderSize) / sizeof(Entry)) {
+        close();
+        return false;
+    }
+
+    // Reject the whole pack if any entry points outside the file
+    entries = reinterpret_cast<const Entry *>(base + kHeaderSize);
+    count = int(n);
+    for (int i = 0; i < count; ++i) {
+        const Entry &e = entries[i];
+        if (e.offset > quint64(length) || e.size > quint64(length) - e.offset
+            || (i && entries[i - 1].id >= e.id)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetArchive::close()
+{
+    if (base)
+        file.unmap(const_cast<uchar *>(base));
+    file.close();
+    base = nullptr;
+    entries = nullptr;
+    length = 0;
+    count = 0;
+}
+
+AssetView AssetArchive::find(quint32 id) const
+{
+    AssetView v;
+    const Entry *end = entries + count;
+    const Entry *e = std::lower_bound(entries, end, id,
+                                      [](const Entry &a, quint32 key) { return a.id < key; });
+    if (e == end || e->id != id)
+        return v;
+    v.type = AssetType(e->type);
+    v.data = base + e->offset;
+    v.size = qint64(e->size);
+    v.param0 = e->param0;
+    v.param1 = e->param1;
+    return v;
+}
+
+QString AssetArchive::defaultPath()
+{
+    const QString env = qEnvironmentVariable("PACMAN_ASSETS");
+    if (!env.isEmpty())
+        return env;
+    return QCoreApplication::applicationDirPath() + "/assets.pak";
+}
+
+// ----- writer -----
+void AssetPackWriter::add(quint32 id, AssetType type, const QByteArray &payload,
+                          quint32 param0, quint32 param1)
+{
+    items.append({ id, type, payload, param0, param1 });
+}
+
+bool AssetPackWriter::write(const QString &path, QString *error) const
+{
+    QVector<Pending> sorted = items;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Pending &a, const Pending &b) { return a.id < b.id; });
+    for (int i = 1; i < sorted.size(); ++i) {
+        if (sorted[i].id == sorted[i - 1].id) {
+            if (error) *error = QString("duplicate asset id 0x%1").arg(sorted[i].id, 8, 16, QChar('0'));
+            return false;
+        }
+    }
+
+    QByteArray out(kHeaderSize, '\0');
+    std::memcpy(out.data(), kMagic, 4);
+    qToLittleEndian<quint16>(kVersion, out.data() + 4);
+    qToLittleEndian<quint32>(quint32(sorted.size()), out.data() + 8);
+
+    // Table first, then each payload on its own aligned offset
+    const qint64 tableEnd = kHeaderSize + qint64(sorted.size()) * 32;
+    qint64 offset = (tableEnd + kAlign - 1) / kAlign * kAlign;
+    QByteArray table(tableEnd - kHeaderSize, '\0');
+    QVector<qint64> offsets;
+    for (int i = 0; i < sorted.size(); ++i) {
+        const Pending &p = sorted[i];
+        char *e = table.data() + i * 32;
+        qToLittleEndian<quint32>(p.id, e);
+        qToLittleEndian<quint32>(quint32(p.type), e + 4);
+        qToLittleEndian<quint64>(quint64(offset), e + 8);
+        qToLittleEndian<quint64>(quint64(p.payload.size()), e + 16);
+        qToLittleEndian<quint32>(p.param0, e + 24);
+        qToLittleEndian<quint32>(p.param1, e + 28);
+        offsets.append(offset);
+        offset = (offset + p.payload.size() + kAlign - 1) / kAlign * kAlign;
+    }
+    out += table;
+
+    for (int i = 0; i < sorted.size(); ++i) {
+        out.append(QByteArray(offsets[i] - out.size(), '\0'));
+        out += sorted[i].payload;
+    }
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly) || f.write(out) != out.size() || !f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return true;
+}
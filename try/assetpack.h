@@ -0,0 +1,110 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// ==============================
+// 📦 PACKED ASSET ARCHIVE
+// ==============================
+
+// assets.pak is produced once at build time by tools/assetpack: raw PCM,
+// pre-rasterized tiles and the bundled font, each payload 64-byte
+// aligned. At runtime the whole file is memory-mapped and payloads are
+// used in place, so loading an asset is a binary search and a pointer.
+//
+// Layout (little endian):
+//   header   "PMAK", u16 version, u16 reserved, u32 entryCount, u32 0
+//   entries  entryCount x { u32 id, u32 type, u64 offset, u64 size,
+//                           u32 param0, u32 param1 }, sorted by id
+//   payloads
+
+// FNV-1a, so every lookup key is folded at compile time
+constexpr quint32 assetId(const char *name, quint32 hash = 2166136261u)
+{
+    return *name ? assetId(name + 1, (hash ^ quint8(*name)) * 16777619u) : hash;
+}
+
+// Same asset at another size or rate, e.g. tiles for one cell size
+constexpr quint32 assetVariant(quint32 id, quint32 variant)
+{
+    for (int i = 0; i < 4; ++i)
+        id = (id ^ ((variant >> (8 * i)) & 0xFF)) * 16777619u;
+    return id;
+}
+
+namespace AssetIds {
+constexpr quint32 SfxEat = assetId("sfx/eat");        // variant: sample rate
+constexpr quint32 SfxDeath = assetId("sfx/death");
+constexpr quint32 SfxWin = assetId("sfx/win");
+constexpr quint32 Tiles = assetId("sprites/tiles");   // variant: cell size
+constexpr quint32 FontRetro = assetId("font/retro");
+}
+
+enum class AssetType : quint32 {
+    Pcm16Mono = 1,    // param0: sample rate
+    Tiles8 = 2,       // param0: cell size, param1: tile count
+    Font = 3          // TTF/OTF bytes
+};
+
+struct AssetView {
+    AssetType type = AssetType(0);
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    quint32 param0 = 0, param1 = 0;
+
+    bool isValid() const { return data != nullptr; }
+};
+
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive &) = delete;
+    AssetArchive &operator=(const AssetArchive &) = delete;
+
+    // Maps the file and checks the table; nothing is copied.
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    AssetView find(quint32 id) const;
+    qint64 mappedBytes() const { return length; }
+
+    // PACMAN_ASSETS if set, else assets.pak next to the executable
+    static QString defaultPath();
+
+private:
+    struct Entry;
+
+    QFile file;
+    const uchar *base = nullptr;
+    qint64 length = 0;
+    const Entry *entries = nullptr;
+    int count = 0;
+};
+
+// Build-side counterpart, used by tools/assetpack
+class AssetPackWriter
+{
+public:
+    void add(quint32 id, AssetType type, const QByteArray &payload,
+             quint32 param0 = 0, quint32 param1 = 0);
+    bool write(const QString &path, QString *error = nullptr) const;
+
+private:
+    struct Pending {
+        quint32 id;
+        AssetType type;
+        QByteArray payload;
+        quint32 param0, param1;
+    };
+    QVector<Pending> items;
+};
+
+#endif // ASSETPACK_H
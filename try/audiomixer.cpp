@@ -0,0 +1,313 @@
+#include "audiomixer.h"
+#include <QFile>
+#include <QtEndian>
+#include <QtMultimedia/QAudioDevice>
+#include <QtMultimedia/QAudioFormat>
+#include <QtMultimedia/QAudioSink>
+#include <QtMultimedia/QMediaDevices>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+AudioMixer::AudioMixer(QObject *parent)
+    : QIODevice(parent), rate(48000)
+{
+    clock.start();
+    open(QIODevice::ReadOnly);
+}
+
+AudioMixer::~AudioMixer()
+{
+    stopOutput();
+}
+
+void AudioMixer::initialize()
+{
+    // Mix at the device's native rate so the backend never resamples
+    const QAudioDevice dev = QMediaDevices::defaultAudioOutput();
+    if (!dev.isNull()) {
+        QAudioFormat fmt;
+        fmt.setSampleRate(dev.preferredFormat().sampleRate());
+        fmt.setChannelCount(kChannels);
+        fmt.setSampleFormat(QAudioFormat::Int16);
+        if (fmt.sampleRate() > 0 && dev.isFormatSupported(fmt))
+            rate = fmt.sampleRate();
+    }
+
+    QMutexLocker locker(&lock);
+    music.setSampleRate(rate);
+}
+
+// Minimal RIFF reader: PCM 8/16-bit, any channel count and rate. The clip
+// is downmixed to mono (panning happens per voice) and linearly resampled
+// to the mixer rate.
+bool AudioMixer::loadWav(Sound id, const QString &path)
+{
+    if (id < 0 || id >= SoundCount) return false;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray bytes = f.readAll();
+    const char *base = bytes.constData();
+
+    if (bytes.size() < 12 || !bytes.startsWith("RIFF") || bytes.mid(8, 4) != "WAVE")
+        return false;
+
+    int channels = 0, srcRate = 0, bits = 0;
+    const char *data = nullptr;
+    qint64 dataLen = 0;
+    for (qint64 off = 12; off + 8 <= bytes.size();) {
+        const QByteArray chunk = bytes.mid(off, 4);
+        qint64 len = qFromLittleEndian<quint32>(base + off + 4);
+        const qint64 body = off + 8;
+        len = qMin<qint64>(len, bytes.size() - body);
+        if (chunk == "fmt " && len >= 16) {
+            if (qFromLittleEndian<quint16>(base + body) != 1) return false;   // PCM only
+            channels = qFromLittleEndian<quint16>(base + body + 2);
+            srcRate = int(qFromLittleEndian<quint32>(base + body + 4));
+            bits = qFromLittleEndian<quint16>(base + body + 14);
+        } else if (chunk == "data") {
+            data = base + body;
+            dataLen = len;
+        }
+        off = body + len + (len & 1);
+    }
+    if (!data || channels < 1 || srcRate <= 0 || (bits != 8 && bits != 16))
+        return false;
+
+    const int bytesPerFrame = channels * bits / 8;
+    const qint64 frames = dataLen / bytesPerFrame;
+    QVector<qint16> mono(frames);
+    for (qint64 i = 0; i < frames; ++i) {
+        const char *p = data + i * bytesPerFrame;
+        int sum = 0;
+        for (int c = 0; c < channels; ++c) {
+            sum += (bits == 16) ? qFromLittleEndian<qint16>(p + 2 * c)
+                                : (int(uchar(p[c])) - 128) << 8;
+        }
+        mono[i] = qint16(sum / channels);
+    }
+
+    QVector<qint16> pcm;
+    if (srcRate == rate || frames < 2) {
+        pcm = mono;
+    } else {
+        const qint64 outFrames = frames * rate / srcRate;
+        pcm.resize(outFrames);
+        const double step = double(srcRate) / rate;
+        for (qint64 j = 0; j < outFrames; ++j) {
+            const double pos = j * step;
+            const qint64 i0 = qMin<qint64>(qint64(pos), frames - 2);
+            const double frac = pos - i0;
+            pcm[j] = qint16(mono[i0] * (1.0 - frac) + mono[i0 + 1] * frac);
+        }
+    }
+
+    setClip(id, pcm, pcm.constData(), int(pcm.size()));
+    return true;
+}
+
+void AudioMixer::loadSong(Sound id, const ChipSong &song)
+{
+    if (id < 0 || id >= SoundCount) return;
+    const QVector<qint16> pcm = ChipPlayer::renderClip(song, rate);
+    setClip(id, pcm, pcm.constData(), int(pcm.size()));
+}
+
+void AudioMixer::loadPcm(Sound id, const qint16 *pcm, int frames)
+{
+    if (id < 0 || id >= SoundCount) return;
+    setClip(id, QVector<qint16>(), pcm, frames);
+}
+
+// Voices still on the old clip are cut, never left pointing at freed data
+void AudioMixer::setClip(Sound id, const QVector<qint16> &owned, const qint16 *data, int frames)
+{
+    QMutexLocker locker(&lock);
+    for (Voice &v : voices)
+        if (v.clip == &clips[id]) v.clip = nullptr;
+    Clip &c = clips[id];
+    c.owned = owned;
+    c.data = data;
+    c.frames = frames;
+}
+
+void AudioMixer::play(Sound id, float volume, float pan)
+{
+    if (id < 0 || id >= SoundCount) return;
+    volume = qBound(0.0f, volume, 1.0f);
+    pan = qBound(-1.0f, pan, 1.0f);
+    const float l = volume * (pan <= 0.0f ? 1.0f : 1.0f - pan);
+    const float r = volume * (pan >= 0.0f ? 1.0f : 1.0f + pan);
+
+    QMutexLocker locker(&lock);
+    if (clips[id].frames <= 0) return;
+
+    // Free voice if there is one, otherwise steal the one furthest along
+    int slot = -1, victim = 0;
+    for (int i = 0; i < kMaxVoices; ++i) {
+        if (!voices[i].clip) { slot = i; break; }
+        if (voices[i].pos > voices[victim].pos) victim = i;
+    }
+    if (slot < 0) slot = victim;
+
+    Voice &v = voices[slot];
+    v.clip = &clips[id];
+    v.pos = 0;
+    v.gainL = qint16(l * 32767.0f);
+    v.gainR = qint16(r * 32767.0f);
+    v.triggerNs = clock.nsecsElapsed();
+    v.started = false;
+}
+
+void AudioMixer::stopAll()
+{
+    QMutexLocker locker(&lock);
+    for (Voice &v : voices)
+        v.clip = nullptr;
+}
+
+void AudioMixer::setMusic(const ChipSong *song)
+{
+    QMutexLocker locker(&lock);
+    music.setSong(song);
+}
+
+void AudioMixer::setMusicVolume(float volume)
+{
+    QMutexLocker locker(&lock);
+    musicGain = qint16(qBound(0.0f, volume, 1.0f) * 32767.0f);
+}
+
+bool AudioMixer::startOutput(int bufferMs)
+{
+    if (sink) return true;
+
+    QAudioFormat fmt;
+    fmt.setSampleRate(rate);
+    fmt.setChannelCount(kChannels);
+    fmt.setSampleFormat(QAudioFormat::Int16);
+
+    const QAudioDevice dev = QMediaDevices::defaultAudioOutput();
+    if (dev.isNull() || !dev.isFormatSupported(fmt))
+        return false;
+
+    sink = new QAudioSink(dev, fmt, this);
+    sink->setBufferSize(qsizetype(rate) * kChannels * sizeof(qint16) * bufferMs / 1000);
+    sink->start(this);
+
+    QMutexLocker locker(&lock);
+    outputDelayNs = qint64(sink->bufferSize()) * 1000000000 / (qint64(rate) * kChannels * sizeof(qint16));
+    return sink->error() == QAudio::NoError;
+}
+
+void AudioMixer::stopOutput()
+{
+    if (!sink) return;
+    sink->stop();
+    delete sink;
+    sink = nullptr;
+}
+
+TimingHistogram AudioMixer::latencyStats() const
+{
+    QMutexLocker locker(&lock);
+    return latency;
+}
+
+TimingHistogram AudioMixer::mixCostStats() const
+{
+    QMutexLocker locker(&lock);
+    return mixCost;
+}
+
+qint64 AudioMixer::bytesAvailable() const
+{
+    // Endless stream: silence is mixed whenever no voice is playing
+    return QIODevice::bytesAvailable() + qint64(rate) * kChannels * sizeof(qint16);
+}
+
+qint64 AudioMixer::readData(char *data, qint64 maxlen)
+{
+    const int frameBytes = kChannels * sizeof(qint16);
+    const int frames = int(maxlen / frameBytes);
+    render(reinterpret_cast<qint16 *>(data), frames);
+    return qint64(frames) * frameBytes;
+}
+
+qint64 AudioMixer::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+void AudioMixer::render(qint16 *out, int frames)
+{
+    QMutexLocker locker(&lock);
+    const int n = frames * kChannels;
+    if (accum.size() < n) accum.resize(n);
+    std::fill(accum.begin(), accum.begin() + n, 0);
+
+    const qint64 now = clock.nsecsElapsed();
+    for (Voice &v : voices) {
+        if (!v.clip) continue;
+        if (!v.started) {
+            v.started = true;
+            latency.record(now - v.triggerNs + outputDelayNs);
+        }
+        const int count = qMin(frames, v.clip->frames - v.pos);
+        mixVoice(accum.data(), v.clip->data + v.pos, count, v.gainL, v.gainR);
+        v.pos += count;
+        if (v.pos >= v.clip->frames) v.clip = nullptr;
+    }
+
+    if (musicPlaying && !music.isFinished()) {
+        if (musicBuf.size() < frames) musicBuf.resize(frames);
+        music.render(musicBuf.data(), frames);
+        mixVoice(accum.data(), musicBuf.constData(), frames, musicGain, musicGain);
+    }
+
+    // Saturate the 32-bit mix bus down to 16-bit output
+    const qint32 *acc = accum.constData();
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 8 <= n; i += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(a, b));
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = qint16(qBound(-32768, acc[i], 32767));
+
+    mixCost.record(clock.nsecsElapsed() - now);
+}
+
+// acc[2i] += src[i] * gainL >> 15, acc[2i+1] += src[i] * gainR >> 15
+void AudioMixer::mixVoice(qint32 *acc, const qint16 *src, int frames,
+                          qint16 gainL, qint16 gainR)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i g = _mm_set_epi16(gainR, gainL, gainR, gainL, gainR, gainL, gainR, gainL);
+    for (; i + 8 <= frames; i += 8) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i halves[2] = { _mm_unpacklo_epi16(s, s), _mm_unpackhi_epi16(s, s) };
+        for (int h = 0; h < 2; ++h) {
+            // full 32-bit products from the low and high 16-bit halves
+            const __m128i lo = _mm_mullo_epi16(halves[h], g);
+            const __m128i hi = _mm_mulhi_epi16(halves[h], g);
+            __m128i *dst = reinterpret_cast<__m128i *>(acc + 2 * i + 8 * h);
+            const __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+            const __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+            _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), p0));
+            _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), p1));
+        }
+    }
+#endif
+    for (; i < frames; ++i) {
+        acc[2 * i]     += (src[i] * gainL) >> 15;
+        acc[2 * i + 1] += (src[i] * gainR) >> 15;
+    }
+}
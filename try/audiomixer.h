@@ -0,0 +1,122 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "chipsynth.h"
+#include "framescheduler.h"
+
+class QAudioSink;
+
+// ==============================
+// 🔊 SOFTWARE AUDIO MIXER
+// ==============================
+
+// Mixes short sound effects in-process into a single QAudioSink. Clips
+// are synthesized (or decoded from WAV) once into mono 16-bit PCM at the
+// mixer rate; each play() takes a voice from a fixed pool (stealing the
+// oldest when full) with its own volume and stereo pan, so rapid pellets
+// overlap instead of cutting each other off.
+//
+// The mixer is the sink's pull-mode QIODevice. render() is the same mix
+// without a device, which is what a null sink uses. play() and the music
+// controls may be called from any thread; initialize(), loadWav() and
+// startOutput() belong to the thread the mixer lives on.
+class AudioMixer : public QIODevice
+{
+    Q_OBJECT
+public:
+    enum Sound { Eat, Death, Win, SoundCount };
+
+    static constexpr int kChannels = 2;
+    static constexpr int kMaxVoices = 16;
+
+    explicit AudioMixer(QObject *parent = nullptr);
+    ~AudioMixer() override;
+
+    // Picks the device's native rate. Slow on some backends, so call it
+    // on the audio thread before loading clips or starting output.
+    void initialize();
+    int sampleRate() const { return rate; }
+
+    bool loadWav(Sound id, const QString &path);
+    void loadSong(Sound id, const ChipSong &song);
+    // Mono PCM already at sampleRate(); used in place, must stay valid
+    void loadPcm(Sound id, const qint16 *pcm, int frames);
+
+    // pan: -1 = hard left, 0 = centre, 1 = hard right
+    void play(Sound id, float volume = 1.0f, float pan = 0.0f);
+    void stopAll();
+
+    // Music bed: synthesized live on the mixer thread, under the effects
+    void setMusic(const ChipSong *song);
+    void setMusicVolume(float volume);
+    void setMusicPlaying(bool playing) { musicPlaying = playing; }
+
+    // Opens the default output in pull mode with a small buffer.
+    bool startOutput(int bufferMs = 20);
+    void stopOutput();
+
+    // Mixes `frames` interleaved stereo frames into out.
+    void render(qint16 *out, int frames);
+
+    // Time from play() to the voice's first sample leaving the mixer,
+    // plus whatever the sink still had queued at that moment.
+    TimingHistogram latencyStats() const;
+
+    // Wall time of each render() call, music synthesis included
+    TimingHistogram mixCostStats() const;
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    // Decoded samples, or a view into the mapped asset archive
+    struct Clip {
+        QVector<qint16> owned;
+        const qint16 *data = nullptr;
+        int frames = 0;
+    };
+
+    struct Voice {
+        const Clip *clip = nullptr;
+        int pos = 0;
+        qint16 gainL = 0, gainR = 0;   // Q15
+        qint64 triggerNs = 0;
+        bool started = false;
+    };
+
+    static void mixVoice(qint32 *acc, const qint16 *src, int frames,
+                         qint16 gainL, qint16 gainR);
+
+    void setClip(Sound id, const QVector<qint16> &owned, const qint16 *data, int frames);
+
+    int rate;
+    Clip clips[SoundCount];
+
+    mutable QMutex lock;
+    Voice voices[kMaxVoices];
+    QVector<qint32> accum;
+    QElapsedTimer clock;
+    qint64 outputDelayNs = 0;
+    TimingHistogram latency;
+    TimingHistogram mixCost;
+
+    ChipPlayer music;
+    std::atomic<bool> musicPlaying{false};
+    qint16 musicGain = 32767;
+    QVector<qint16> musicBuf;
+
+    QAudioSink *sink = nullptr;
+};
+
+#endif // AUDIOMIXER_H
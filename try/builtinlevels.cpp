@@ -0,0 +1,474 @@
+#include "builtinlevels.h"
+#include "levelcompiler.h"
+#include <array>
+#include <iterator>
+
+namespace {
+
+// Level 4 – custom
+constexpr QPoint lvl4[] = {
+    QPoint(1, 2), QPoint(2, 2), QPoint(3, 2), QPoint(3, 3), QPoint(3, 4), QPoint(2, 4),
+    QPoint(6, 2), QPoint(6, 3), QPoint(6, 4), QPoint(7, 4), QPoint(8, 4), QPoint(8, 3),
+    QPoint(10, 10), QPoint(11, 10), QPoint(12, 10), QPoint(13, 10), QPoint(15, 10),
+    QPoint(14, 10), QPoint(15, 11), QPoint(15, 12), QPoint(13, 13), QPoint(14, 13),
+    QPoint(15, 13), QPoint(10, 13), QPoint(9, 13), QPoint(8, 13), QPoint(8, 12),
+    QPoint(8, 11), QPoint(8, 10), QPoint(9, 10), QPoint(10, 3), QPoint(11, 3),
+    QPoint(11, 4), QPoint(11, 5), QPoint(11, 6), QPoint(10, 6), QPoint(9, 6),
+    QPoint(16, 2), QPoint(15, 2), QPoint(15, 3), QPoint(15, 4), QPoint(15, 5),
+    QPoint(16, 5), QPoint(17, 5), QPoint(18, 5), QPoint(18, 4), QPoint(18, 3),
+    QPoint(19, 3), QPoint(20, 3), QPoint(20, 4), QPoint(13, 4), QPoint(13, 5),
+    QPoint(13, 6), QPoint(13, 7), QPoint(14, 7), QPoint(15, 7), QPoint(16, 7),
+    QPoint(17, 7), QPoint(18, 7), QPoint(20, 6), QPoint(20, 7), QPoint(22, 3),
+    QPoint(23, 3), QPoint(22, 4), QPoint(22, 5), QPoint(1, 6), QPoint(2, 6),
+    QPoint(3, 6), QPoint(3, 7), QPoint(3, 9), QPoint(3, 10), QPoint(2, 10),
+    QPoint(1, 10), QPoint(5, 8), QPoint(5, 9), QPoint(5, 10), QPoint(5, 11),
+    QPoint(6, 11), QPoint(6, 12), QPoint(6, 13), QPoint(5, 13), QPoint(4, 13),
+    QPoint(2, 13), QPoint(3, 13), QPoint(2, 12), QPoint(7, 8), QPoint(7, 7),
+    QPoint(7, 6), QPoint(6, 6), QPoint(5, 6), QPoint(17, 13), QPoint(18, 13),
+    QPoint(19, 13), QPoint(20, 13), QPoint(20, 12), QPoint(20, 11), QPoint(23, 12),
+    QPoint(20, 10), QPoint(21, 10), QPoint(22, 10), QPoint(9, 8), QPoint(10, 8),
+    QPoint(11, 8), QPoint(1, 15), QPoint(2, 15), QPoint(3, 15), QPoint(4, 15),
+    QPoint(4, 16), QPoint(4, 17), QPoint(4, 18), QPoint(5, 18), QPoint(6, 18),
+    QPoint(2, 18), QPoint(2, 17), QPoint(2, 19), QPoint(2, 20), QPoint(3, 20),
+    QPoint(4, 20), QPoint(4, 21), QPoint(7, 18), QPoint(7, 19), QPoint(6, 22),
+    QPoint(6, 21), QPoint(7, 21), QPoint(8, 21), QPoint(9, 21), QPoint(9, 16),
+    QPoint(9, 17), QPoint(9, 18), QPoint(9, 15), QPoint(7, 15), QPoint(8, 15),
+    QPoint(4, 22), QPoint(14, 8), QPoint(11, 15), QPoint(12, 15), QPoint(13, 15),
+    QPoint(14, 15), QPoint(14, 16), QPoint(14, 17), QPoint(13, 17), QPoint(12, 17),
+    QPoint(12, 18), QPoint(12, 19), QPoint(11, 19), QPoint(17, 14), QPoint(17, 15),
+    QPoint(17, 16), QPoint(17, 17), QPoint(16, 17), QPoint(16, 18), QPoint(16, 19),
+    QPoint(15, 19), QPoint(15, 20), QPoint(17, 12), QPoint(17, 11), QPoint(17, 10),
+    QPoint(15, 21), QPoint(14, 21), QPoint(13, 21), QPoint(19, 17), QPoint(19, 18),
+    QPoint(19, 19), QPoint(18, 19), QPoint(19, 16), QPoint(20, 16), QPoint(21, 16),
+    QPoint(22, 16), QPoint(22, 17), QPoint(20, 21), QPoint(21, 21), QPoint(19, 21),
+    QPoint(21, 18), QPoint(22, 18), QPoint(21, 19), QPoint(21, 20), QPoint(18, 21),
+    QPoint(18, 22), QPoint(22, 12), QPoint(22, 13), QPoint(22, 14)
+};
+
+// Level 2 – custom
+constexpr QPoint lvl2[] = {
+    QPoint(5,2), QPoint(5,3), QPoint(5,4), QPoint(5,5), QPoint(4,5), QPoint(2,2), QPoint(2,3),
+    QPoint(3,2), QPoint(3,3), QPoint(3,5), QPoint(3,6), QPoint(3,7), QPoint(2,9), QPoint(3,9),
+    QPoint(3,10), QPoint(3,11), QPoint(3,12), QPoint(2,12), QPoint(16,10), QPoint(15,9),
+    QPoint(14,8), QPoint(13,8), QPoint(12,9), QPoint(11,10), QPoint(16,14), QPoint(15,15),
+    QPoint(11,14), QPoint(12,15), QPoint(13,16), QPoint(14,16), QPoint(16,11), QPoint(16,13),
+    QPoint(11,11), QPoint(11,13), QPoint(17,11), QPoint(18,11), QPoint(17,13), QPoint(18,13),
+    QPoint(5,11), QPoint(6,11), QPoint(7,11), QPoint(9,8), QPoint(9,9), QPoint(9,10),
+    QPoint(9,11), QPoint(8,11), QPoint(5,9), QPoint(6,9), QPoint(7,9), QPoint(7,6),
+    QPoint(7,7), QPoint(6,7), QPoint(6,5), QPoint(7,5), QPoint(8,3), QPoint(8,2),
+    QPoint(10,2), QPoint(9,2), QPoint(11,2), QPoint(12,2), QPoint(13,2), QPoint(11,3),
+    QPoint(11,4), QPoint(10,4), QPoint(10,5), QPoint(10,6), QPoint(14,5), QPoint(15,5),
+    QPoint(15,4), QPoint(15,3), QPoint(16,3), QPoint(17,3), QPoint(17,2), QPoint(18,2),
+    QPoint(19,2), QPoint(19,3), QPoint(19,4), QPoint(19,5), QPoint(18,5), QPoint(17,5),
+    QPoint(19,11), QPoint(20,11), QPoint(19,13), QPoint(20,13), QPoint(22,2), QPoint(22,3),
+    QPoint(21,3), QPoint(21,4), QPoint(21,5), QPoint(22,5), QPoint(22,6), QPoint(22,7),
+    QPoint(21,7), QPoint(20,7), QPoint(18,7), QPoint(19,7), QPoint(22,9), QPoint(22,10),
+    QPoint(20,9), QPoint(21,9), QPoint(19,9), QPoint(22,13), QPoint(22,14), QPoint(22,15),
+    QPoint(22,16), QPoint(21,16), QPoint(20,16), QPoint(19,16), QPoint(18,16), QPoint(18,18),
+    QPoint(18,15), QPoint(19,15), QPoint(6,14), QPoint(5,15), QPoint(4,16), QPoint(3,17),
+    QPoint(2,18), QPoint(9,14), QPoint(8,15), QPoint(7,16), QPoint(6,17), QPoint(5,18),
+    QPoint(4,19), QPoint(4,20), QPoint(4,21), QPoint(6,12), QPoint(1,18), QPoint(2,14),
+    QPoint(2,13), QPoint(2,15), QPoint(14,12), QPoint(13,12), QPoint(13,11), QPoint(14,11),
+    QPoint(14,13), QPoint(13,13), QPoint(8,19), QPoint(7,19), QPoint(7,20), QPoint(14,22),
+    QPoint(15,22), QPoint(16,22), QPoint(16,20), QPoint(16,21), QPoint(16,19), QPoint(20,18),
+    QPoint(20,19), QPoint(20,20), QPoint(19,20), QPoint(18,20), QPoint(18,21), QPoint(18,22),
+    QPoint(19,22), QPoint(20,22), QPoint(21,22), QPoint(22,22), QPoint(22,18), QPoint(22,19),
+    QPoint(22,20), QPoint(10,19), QPoint(9,19), QPoint(11,21), QPoint(11,19), QPoint(11,20),
+    QPoint(11,18), QPoint(11,17), QPoint(10,17), QPoint(11,22), QPoint(12,20), QPoint(12,19),
+    QPoint(12,21), QPoint(2,21), QPoint(3,21), QPoint(2,22), QPoint(3,22), QPoint(4,22),
+    QPoint(7,21), QPoint(7,22), QPoint(8,22), QPoint(9,22), QPoint(9,21), QPoint(16,17),
+    QPoint(17,17), QPoint(18,17), QPoint(16,18), QPoint(15,19), QPoint(14,19), QPoint(13,5),
+    QPoint(13,6), QPoint(14,6)
+};
+
+// Level 3 – custom
+constexpr QPoint lvl3[] = {
+    QPoint(5,2), QPoint(5,3), QPoint(5,4), QPoint(5,5), QPoint(5,6), QPoint(19,2), QPoint(19,3),
+    QPoint(19,4), QPoint(19,5), QPoint(19,6), QPoint(7,2), QPoint(8,2), QPoint(9,2), QPoint(10,2),
+    QPoint(17,2), QPoint(16,2), QPoint(15,2), QPoint(14,2), QPoint(2,2), QPoint(3,2), QPoint(3,3),
+    QPoint(2,3), QPoint(2,5), QPoint(3,5), QPoint(3,6), QPoint(2,6), QPoint(21,2), QPoint(22,2),
+    QPoint(22,3), QPoint(21,3), QPoint(21,5), QPoint(22,5), QPoint(22,6), QPoint(21,6), QPoint(2,21),
+    QPoint(2,22), QPoint(3,22), QPoint(3,21), QPoint(5,22), QPoint(5,21), QPoint(5,20), QPoint(5,19),
+    QPoint(5,18), QPoint(2,18), QPoint(3,18), QPoint(3,19), QPoint(2,19), QPoint(22,22), QPoint(21,22),
+    QPoint(21,21), QPoint(22,21), QPoint(21,19), QPoint(21,18), QPoint(22,18), QPoint(22,19), QPoint(19,18),
+    QPoint(19,19), QPoint(19,20), QPoint(19,21), QPoint(19,22), QPoint(7,22), QPoint(8,22), QPoint(9,22),
+    QPoint(10,22), QPoint(14,22), QPoint(15,22), QPoint(16,22), QPoint(17,22), QPoint(7,4), QPoint(8,4),
+    QPoint(7,5), QPoint(16,4), QPoint(17,4), QPoint(17,5), QPoint(7,19), QPoint(7,20), QPoint(8,20),
+    QPoint(17,19), QPoint(17,20), QPoint(16,20), QPoint(4,8), QPoint(4,9), QPoint(4,10), QPoint(4,14),
+    QPoint(4,15), QPoint(4,16), QPoint(2,12), QPoint(3,12), QPoint(4,12), QPoint(5,12), QPoint(6,12),
+    QPoint(20,8), QPoint(20,9), QPoint(20,10), QPoint(20,12), QPoint(19,12), QPoint(21,12), QPoint(22,12),
+    QPoint(18,12), QPoint(20,14), QPoint(20,15), QPoint(20,16), QPoint(12,2), QPoint(12,3), QPoint(12,4),
+    QPoint(12,5), QPoint(12,6), QPoint(12,7), QPoint(12,8), QPoint(12,16), QPoint(12,17), QPoint(12,18),
+    QPoint(12,19), QPoint(12,20), QPoint(12,21), QPoint(12,22), QPoint(2,9), QPoint(22,9), QPoint(22,15),
+    QPoint(2,15), QPoint(8,11), QPoint(8,10), QPoint(8,9), QPoint(8,8), QPoint(8,13), QPoint(8,14),
+    QPoint(8,15), QPoint(8,16), QPoint(9,6), QPoint(10,6), QPoint(10,7), QPoint(10,8), QPoint(9,18),
+    QPoint(10,18), QPoint(10,17), QPoint(10,16), QPoint(10,10), QPoint(10,11), QPoint(10,12), QPoint(10,13),
+    QPoint(10,14), QPoint(5,8), QPoint(6,9), QPoint(7,10), QPoint(5,16), QPoint(6,15), QPoint(7,14),
+    QPoint(14,6), QPoint(15,6), QPoint(14,7), QPoint(14,8), QPoint(14,16), QPoint(14,17), QPoint(14,18),
+    QPoint(15,18), QPoint(14,10), QPoint(14,11), QPoint(14,12), QPoint(14,13), QPoint(16,8), QPoint(16,9),
+    QPoint(16,10), QPoint(16,11), QPoint(16,13), QPoint(16,14), QPoint(16,15), QPoint(16,16), QPoint(17,14),
+    QPoint(18,15), QPoint(19,16), QPoint(17,10), QPoint(18,9), QPoint(19,8), QPoint(9,4), QPoint(15,4),
+    QPoint(9,20), QPoint(15,20), QPoint(11,10), QPoint(13,10), QPoint(11,14), QPoint(14,14), QPoint(13,14),
+    QPoint(12,12)
+};
+
+// Level 1 – custom classic-ish
+constexpr QPoint lvl1[] = {
+    QPoint(2,2), QPoint(2,3), QPoint(2,4), QPoint(2,5), QPoint(2,6), QPoint(3,2), QPoint(4,2),
+    QPoint(5,2), QPoint(6,2), QPoint(7,2), QPoint(6,3), QPoint(3,6), QPoint(2,7), QPoint(6,4),
+    QPoint(4,6), QPoint(22,2), QPoint(21,2), QPoint(20,2), QPoint(19,2), QPoint(18,2), QPoint(17,2),
+    QPoint(22,3), QPoint(22,4), QPoint(22,5), QPoint(22,6), QPoint(22,7), QPoint(18,3), QPoint(18,4),
+    QPoint(20,6), QPoint(21,6), QPoint(2,22), QPoint(2,21), QPoint(2,20), QPoint(2,19), QPoint(2,18),
+    QPoint(2,17), QPoint(3,22), QPoint(4,22), QPoint(5,22), QPoint(6,22), QPoint(7,22), QPoint(3,18),
+    QPoint(4,18), QPoint(6,21), QPoint(6,20), QPoint(22,17), QPoint(22,18), QPoint(22,19), QPoint(22,20),
+    QPoint(22,21), QPoint(22,22), QPoint(21,22), QPoint(20,22), QPoint(19,22), QPoint(18,22), QPoint(17,22),
+    QPoint(18,21), QPoint(18,20), QPoint(21,18), QPoint(20,18), QPoint(4,20), QPoint(20,20), QPoint(20,4),
+    QPoint(4,4), QPoint(6,6), QPoint(6,7), QPoint(6,8), QPoint(6,9), QPoint(6,10), QPoint(6,18),
+    QPoint(6,17), QPoint(6,16), QPoint(6,15), QPoint(6,14), QPoint(18,18), QPoint(18,17), QPoint(18,16),
+    QPoint(18,15), QPoint(18,14), QPoint(18,6), QPoint(18,7), QPoint(18,8), QPoint(18,9), QPoint(18,10),
+    QPoint(9,2), QPoint(10,2), QPoint(11,2), QPoint(13,2), QPoint(14,2), QPoint(15,2), QPoint(9,22),
+    QPoint(10,22), QPoint(11,22), QPoint(13,22), QPoint(14,22), QPoint(15,22), QPoint(4,8), QPoint(4,9),
+    QPoint(4,10), QPoint(4,14), QPoint(4,15), QPoint(4,16), QPoint(20,8), QPoint(20,9), QPoint(20,10),
+    QPoint(20,14), QPoint(20,15), QPoint(20,16), QPoint(21,12), QPoint(22,12), QPoint(2,12), QPoint(3,12),
+    QPoint(22,9), QPoint(22,10), QPoint(22,11), QPoint(2,9), QPoint(2,10), QPoint(2,11), QPoint(22,13),
+    QPoint(22,14), QPoint(22,15), QPoint(2,13), QPoint(2,14), QPoint(2,15), QPoint(9,4), QPoint(10,5),
+    QPoint(11,6), QPoint(12,7), QPoint(13,8), QPoint(14,9), QPoint(15,10), QPoint(15,4), QPoint(14,5),
+    QPoint(13,6), QPoint(11,8), QPoint(10,9), QPoint(9,10), QPoint(9,20), QPoint(10,19), QPoint(11,18),
+    QPoint(12,17), QPoint(13,16), QPoint(14,15), QPoint(15,14), QPoint(11,16), QPoint(10,15), QPoint(9,14),
+    QPoint(13,18), QPoint(14,19), QPoint(15,20), QPoint(16,6), QPoint(16,7), QPoint(16,8), QPoint(8,6),
+    QPoint(8,7), QPoint(8,8), QPoint(8,16), QPoint(8,17), QPoint(8,18), QPoint(16,16), QPoint(16,17),
+    QPoint(16,18), QPoint(12,10), QPoint(12,11), QPoint(12,12), QPoint(12,13), QPoint(12,14), QPoint(5,12),
+    QPoint(6,12), QPoint(8,12), QPoint(9,12), QPoint(15,12), QPoint(16,12), QPoint(18,12), QPoint(19,12)
+};
+
+// ==============================
+// 🔥 COMPILE-TIME BAKING
+// ==============================
+
+// Everything LevelCompiler would work out for these levels is done by the
+// compiler instead: walls, reachable cells, pellets, landmark distances
+// and the junction graph all end up as read-only data, and the
+// static_asserts below reject a wall outside the board or a walled-in
+// spawn at build time. Same rules and ordering as levelcompiler.cpp.
+
+constexpr int kCells = kRows * kCols;
+constexpr int kStride = (kCols + 7) / 8;
+constexpr int kLandmarks = LevelCompiler::kDefaultLandmarks;
+constexpr QPoint kSpawn(1, 1);
+constexpr int kDirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+struct Bits {
+    std::array<uchar, kStride * kRows> bytes{};
+
+    constexpr bool test(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && x < kCols && y < kRows
+            && ((bytes[y * kStride + x / 8] >> (x % 8)) & 1);
+    }
+    constexpr void set(int x, int y, bool on = true)
+    {
+        uchar &b = bytes[y * kStride + x / 8];
+        b = on ? uchar(b | (1 << (x % 8))) : uchar(b & ~(1 << (x % 8)));
+    }
+};
+
+using Distances = std::array<quint16, kCells>;
+
+struct Baked {
+    Bits walls, reachable, food;
+    std::array<quint16, kLandmarks * kCells> landmarks{};
+    int landmarkCount = 0;
+};
+
+template <std::size_t N>
+constexpr bool inRange(const QPoint (&points)[N])
+{
+    for (const QPoint &p : points)
+        if (p.x() < 0 || p.y() < 0 || p.x() >= kCols || p.y() >= kRows)
+            return false;
+    return true;
+}
+
+template <std::size_t N>
+constexpr Bits bakeWalls(const QPoint (&points)[N])
+{
+    Bits w;
+    for (int x = 0; x < kCols; ++x) {
+        w.set(x, 0);
+        w.set(x, kRows - 1);
+    }
+    for (int y = 0; y < kRows; ++y) {
+        w.set(0, y);
+        w.set(kCols - 1, y);
+    }
+    for (const QPoint &p : points)
+        w.set(p.x(), p.y());
+    return w;
+}
+
+// Breadth-first distances over open cells (clear bits of walls)
+constexpr Distances distancesFrom(const Bits &walls, int start)
+{
+    Distances dist{};
+    for (quint16 &d : dist) d = LandmarkTable::kUnreached;
+    std::array<int, kCells> queue{};
+    int tail = 0;
+    dist[start] = 0;
+    queue[tail++] = start;
+    for (int head = 0; head < tail; ++head) {
+        const int c = queue[head];
+        const int x = c % kCols, y = c / kCols;
+        for (const auto &d : kDirs) {
+            const int nx = x + d[0], ny = y + d[1];
+            if (nx < 0 || ny < 0 || nx >= kCols || ny >= kRows || walls.test(nx, ny)) continue;
+            const int n = ny * kCols + nx;
+            if (dist[n] != LandmarkTable::kUnreached) continue;
+            dist[n] = quint16(dist[c] + 1);
+            queue[tail++] = n;
+        }
+    }
+    return dist;
+}
+
+template <std::size_t N>
+constexpr Baked bake(const QPoint (&points)[N])
+{
+    Baked b;
+    b.walls = bakeWalls(points);
+
+    Distances nearest = distancesFrom(b.walls, kSpawn.y() * kCols + kSpawn.x());
+    for (int c = 0; c < kCells; ++c)
+        if (nearest[c] != LandmarkTable::kUnreached)
+            b.reachable.set(c % kCols, c / kCols);
+    b.food = b.reachable;
+    b.food.set(kSpawn.x(), kSpawn.y(), false);
+
+    // Farthest-point landmarks
+    for (int l = 0; l < kLandmarks; ++l) {
+        int far = -1;
+        for (int c = 0; c < kCells; ++c)
+            if (nearest[c] != LandmarkTable::kUnreached && nearest[c] > 0
+                && (far < 0 || nearest[c] > nearest[far]))
+                far = c;
+        if (far < 0) break;
+
+        const Distances dist = distancesFrom(b.walls, far);
+        for (int c = 0; c < kCells; ++c) {
+            b.landmarks[l * kCells + c] = dist[c];
+            nearest[c] = nearest[c] < dist[c] ? nearest[c] : dist[c];
+        }
+        ++b.landmarkCount;
+    }
+    return b;
+}
+
+constexpr int openNeighbours(const Bits &open, int x, int y)
+{
+    int n = 0;
+    for (const auto &d : kDirs)
+        n += open.test(x + d[0], y + d[1]);
+    return n;
+}
+
+constexpr bool isNode(const Bits &open, int x, int y)
+{
+    return open.test(x, y) && openNeighbours(open, x, y) != 2;
+}
+
+struct GraphSize {
+    int nodes = 0, edges = 0;
+};
+
+// First pass, so the graph arrays below are exactly as big as they need to be
+constexpr GraphSize graphSize(const Bits &open)
+{
+    GraphSize s;
+    for (int y = 0; y < kRows; ++y)
+        for (int x = 0; x < kCols; ++x)
+            if (isNode(open, x, y)) {
+                ++s.nodes;
+                s.edges += openNeighbours(open, x, y);
+            }
+    if (s.nodes == 0 && open.test(kSpawn.x(), kSpawn.y())) {
+        s.nodes = 1;
+        s.edges = openNeighbours(open, kSpawn.x(), kSpawn.y());
+    }
+    return s;
+}
+
+template <int Nodes, int Edges>
+struct BakedGraph {
+    std::array<GraphNode, Nodes> nodes{};
+    std::array<GraphEdge, Edges> edges{};
+    std::array<GraphCell, kCells> cells{};
+};
+
+template <int Nodes, int Edges>
+constexpr BakedGraph<Nodes, Edges> bakeGraph(const Bits &open)
+{
+    BakedGraph<Nodes, Edges> g;
+    std::array<int, kCells> nodeAt{};
+    for (int &n : nodeAt) n = -1;
+    for (GraphCell &c : g.cells) c = GraphCell{ GraphCell::kNone, 0 };
+
+    int n = 0;
+    for (int y = 0; y < kRows; ++y)
+        for (int x = 0; x < kCols; ++x)
+            if (isNode(open, x, y)) {
+                nodeAt[y * kCols + x] = n;
+                g.nodes[n++] = GraphNode{ quint16(x), quint16(y), 0, 0, 0 };
+            }
+    if (n == 0 && Nodes == 1) {
+        nodeAt[kSpawn.y() * kCols + kSpawn.x()] = 0;
+        g.nodes[n++] = GraphNode{ quint16(kSpawn.x()), quint16(kSpawn.y()), 0, 0, 0 };
+    }
+
+    int e = 0;
+    for (int i = 0; i < Nodes; ++i) {
+        GraphNode &node = g.nodes[i];
+        node.firstEdge = quint32(e);
+        g.cells[node.y * kCols + node.x] = GraphCell{ GraphCell::kNodeBit | quint32(i), 0 };
+        for (const auto &d : kDirs) {
+            int px = node.x, py = node.y;
+            int x = node.x + d[0], y = node.y + d[1];
+            if (!open.test(x, y)) continue;
+
+            quint32 length = 1;
+            while (nodeAt[y * kCols + x] < 0) {
+                GraphCell &c = g.cells[y * kCols + x];
+                if (c.ref == GraphCell::kNone)
+                    c = GraphCell{ quint32(e), length };
+                for (const auto &s : kDirs) {
+                    const int nx = x + s[0], ny = y + s[1];
+                    if ((nx != px || ny != py) && open.test(nx, ny)) {
+                        px = x; py = y;
+                        x = nx; y = ny;
+                        break;
+                    }
+                }
+                ++length;
+            }
+            g.edges[e++] = GraphEdge{ quint32(nodeAt[y * kCols + x]), length,
+                                      qint8(d[0]), qint8(d[1]), {0, 0} };
+        }
+        node.edgeCount = quint16(e - int(node.firstEdge));
+    }
+    return g;
+}
+
+static_assert(inRange(lvl1), "level 1 has a wall outside the board");
+static_assert(inRange(lvl2), "level 2 has a wall outside the board");
+static_assert(inRange(lvl3), "level 3 has a wall outside the board");
+static_assert(inRange(lvl4), "level 4 has a wall outside the board");
+
+constexpr Baked level1 = bake(lvl1);
+constexpr Baked level2 = bake(lvl2);
+constexpr Baked level3 = bake(lvl3);
+constexpr Baked level4 = bake(lvl4);
+
+static_assert(!level1.walls.test(kSpawn.x(), kSpawn.y()), "level 1 spawns inside a wall");
+static_assert(!level2.walls.test(kSpawn.x(), kSpawn.y()), "level 2 spawns inside a wall");
+static_assert(!level3.walls.test(kSpawn.x(), kSpawn.y()), "level 3 spawns inside a wall");
+static_assert(!level4.walls.test(kSpawn.x(), kSpawn.y()), "level 4 spawns inside a wall");
+
+constexpr GraphSize graph1Size = graphSize(level1.reachable);
+constexpr GraphSize graph2Size = graphSize(level2.reachable);
+constexpr GraphSize graph3Size = graphSize(level3.reachable);
+constexpr GraphSize graph4Size = graphSize(level4.reachable);
+
+constexpr auto graph1 = bakeGraph<graph1Size.nodes, graph1Size.edges>(level1.reachable);
+constexpr auto graph2 = bakeGraph<graph2Size.nodes, graph2Size.edges>(level2.reachable);
+constexpr auto graph3 = bakeGraph<graph3Size.nodes, graph3Size.edges>(level3.reachable);
+constexpr auto graph4 = bakeGraph<graph4Size.nodes, graph4Size.edges>(level4.reachable);
+
+struct BakedLevel {
+    const Baked *data;
+    const GraphNode *nodes;
+    int nodeCount;
+    const GraphEdge *edges;
+    int edgeCount;
+    const GraphCell *cells;
+};
+
+// Level N plays lvlN
+const BakedLevel bakedLevels[] = {
+    { &level1, graph1.nodes.data(), graph1Size.nodes, graph1.edges.data(), graph1Size.edges,
+      graph1.cells.data() },
+    { &level2, graph2.nodes.data(), graph2Size.nodes, graph2.edges.data(), graph2Size.edges,
+      graph2.cells.data() },
+    { &level3, graph3.nodes.data(), graph3Size.nodes, graph3.edges.data(), graph3Size.edges,
+      graph3.cells.data() },
+    { &level4, graph4.nodes.data(), graph4Size.nodes, graph4.edges.data(), graph4Size.edges,
+      graph4.cells.data() },
+};
+
+template <typename T>
+QByteArray rawBytes(const T *data, int count)
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(data),
+                                   qsizetype(count) * qsizetype(sizeof(T)));
+}
+
+} // namespace
+
+namespace BuiltinLevels {
+
+int count()
+{
+    return int(std::size(bakedLevels));
+}
+
+// Views straight onto the baked arrays; only the enemy roster is built here
+LevelData level(int index)
+{
+    const int rows = kRows, cols = kCols;
+    const BakedLevel &b = bakedLevels[qBound(0, index, count() - 1)];
+    LevelData l;
+    l.name = QString("Level %1").arg(index + 1);
+    l.playerStart = kSpawn;
+    l.walls = BitGrid::fromRawData(cols, rows, b.data->walls.bytes.data());
+    l.reachable = BitGrid::fromRawData(cols, rows, b.data->reachable.bytes.data());
+    l.food = BitGrid::fromRawData(cols, rows, b.data->food.bytes.data());
+    l.graph.nodeData = rawBytes(b.nodes, b.nodeCount);
+    l.graph.edgeData = rawBytes(b.edges, b.edgeCount);
+    l.graph.cellData = rawBytes(b.cells, kCells);
+    l.landmarks.count = b.data->landmarkCount;
+    l.landmarks.cells = kCells;
+    l.landmarks.data = rawBytes(b.data->landmarks.data(), b.data->landmarkCount * kCells);
+
+    QRect topLeft(0, 0, cols/2, rows/2);
+    QRect topRight(cols/2, 0, cols - cols/2, rows/2);
+    QRect bottomLeft(0, rows/2, cols/2, rows - rows/2);
+    QRect bottomRight(cols/2, rows/2, cols - cols/2, rows - rows/2);
+    QVector<Enemy> &enemies = l.enemies;
+
+    switch (index) {
+    case 0:
+        enemies.push_back(Enemy{ 1, rows-2,  1, 0, Qt::green,  EnemyType::Simple, QRect(), 1, 0 });
+        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue,   EnemyType::Simple, QRect(), 1, 1 });
+        enemies.push_back(Enemy{ cols/2, 1, 1, 0, Qt::red, EnemyType::Simple, QRect(), 1, 0 });
+        break;
+    case 1:
+        // Smart enemy in top-left quadrant
+        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::red, EnemyType::Smart, topLeft, 1, 0 });
+
+        // Simple enemies
+        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue, EnemyType::Simple, QRect(), 1, 0 });
+        enemies.push_back(Enemy{ 1, rows-2, 1, 0, Qt::green, EnemyType::Simple, QRect(), 1, 0 });
+        break;
+    case 2:
+        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::red,      EnemyType::Smart,  topLeft,   1, 0 });
+        enemies.push_back(Enemy{ cols-2, 1, -1,0, Qt::magenta, EnemyType::Smart, topRight,  1, 1 });
+        enemies.push_back(Enemy{ 1, rows-2, 1, 0, Qt::green,  EnemyType::Simple, QRect(),   1, 0 });
+        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue,  EnemyType::Simple, QRect(),1, 1 });
+        break;
+    case 3:
+        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::cyan,   EnemyType::Smart,  topLeft, 1, 0 });
+        enemies.push_back(Enemy{ 22, 22, -1,0, Qt::green, EnemyType::Smart, bottomRight, 1, 0 });
+        enemies.push_back(Enemy{ 2, 22, 1, 0, Qt::white,  EnemyType::Smart, bottomLeft, 1, 0 });
+        break;
+    }
+    return l;
+}
+
+} // namespace BuiltinLevels
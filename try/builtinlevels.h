@@ -0,0 +1,22 @@
+#ifndef BUILTINLEVELS_H
+#define BUILTINLEVELS_H
+
+#include "levelpack.h"
+
+// ==============================
+// 🧱 BUILT-IN LEVELS
+// ==============================
+
+// The four hand-made 25x25 levels. The game plays them when no
+// levels.pak is found, and tools/levelpack writes them into one.
+namespace BuiltinLevels {
+
+constexpr int kRows = 25;
+constexpr int kCols = 25;
+
+int count();
+LevelData level(int index);     // 0-based
+
+}
+
+#endif // BUILTINLEVELS_H
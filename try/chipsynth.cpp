@@ -0,0 +1,302 @@
+#include "chipsynth.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr int kEnvMax = 15 << 4;
+
+quint32 dutyFor(ChipWave w)
+{
+    switch (w) {
+    case ChipWave::Pulse12: return 0x20000000u;
+    case ChipWave::Pulse25: return 0x40000000u;
+    default:                return 0x80000000u;
+    }
+}
+
+// One sample of a tonal wave, full scale. Must match the SSE2 path below.
+inline int waveSample(ChipWave w, quint32 phase, quint32 duty)
+{
+    if (w == ChipWave::Triangle) {
+        const quint32 folded = (phase & 0x80000000u) ? ~phase : phase;
+        return int(folded >> 15) - 32768;
+    }
+    return phase < duty ? 32767 : -32768;
+}
+
+inline qint16 addSat(qint16 a, int b)
+{
+    return qint16(qBound(-32768, a + b, 32767));
+}
+
+} // namespace
+
+ChipPlayer::ChipPlayer(int sampleRate)
+{
+    setSampleRate(sampleRate);
+}
+
+void ChipPlayer::setSampleRate(int sampleRate)
+{
+    rate = qMax(1, sampleRate);
+    for (int k = 0; k < 128; ++k) {
+        const double hz = 440.0 * std::pow(2.0, (k - 69) / 12.0);
+        keyInc[k] = quint32(qMin(hz / rate, 0.5) * 4294967296.0 - 1.0);
+    }
+    setSong(song);
+}
+
+void ChipPlayer::setSong(const ChipSong *s)
+{
+    song = s;
+    for (Voice &v : voices)
+        v = Voice();
+    if (!song) return;
+
+    samplesPerTick = double(rate) / qMax(1, song->tickHz);
+    tickCountdown = samplesPerTick;
+    const int count = qMin(song->channelCount, int(kMaxChannels));
+    for (int i = 0; i < count; ++i) {
+        Voice &v = voices[i];
+        v.channel = &song->channels[i];
+        v.done = false;
+        v.sweep = std::pow(2.0, v.channel->sweepCents / 1200.0);
+        startNote(v);
+    }
+}
+
+bool ChipPlayer::isFinished() const
+{
+    for (const Voice &v : voices)
+        if (!v.done) return false;
+    return true;
+}
+
+void ChipPlayer::startNote(Voice &v)
+{
+    const ChipChannel &ch = *v.channel;
+    if (v.note >= ch.noteCount) {
+        if (!song->loop || ch.noteCount == 0) {
+            v.done = true;
+            v.amp = 0;
+            return;
+        }
+        v.note = 0;
+    }
+
+    const ChipNote &n = ch.notes[v.note];
+    v.ticksLeft = qMax(1, int(n.ticks));
+    v.env = n.key ? ch.volume << 4 : 0;
+    if (n.key) v.inc = keyInc[n.key & 127];
+    v.amp = qint16(v.env * 32767 / kEnvMax);
+}
+
+// Sequencer step: envelopes, pitch slides, then note changes
+void ChipPlayer::tick()
+{
+    for (Voice &v : voices) {
+        if (v.done) continue;
+        v.env = qMax(0, v.env - v.channel->decay);
+        if (v.channel->sweepCents)
+            v.inc = quint32(qMin(v.inc * v.sweep, 2147483647.0));
+        v.amp = qint16(v.env * 32767 / kEnvMax);
+        if (--v.ticksLeft <= 0) {
+            ++v.note;
+            startNote(v);
+        }
+    }
+}
+
+void ChipPlayer::render(qint16 *out, int frames)
+{
+    std::fill(out, out + frames, qint16(0));
+    if (!song) return;
+
+    // Render in runs that end on tick boundaries so envelope and note
+    // changes land on the right sample
+    for (int pos = 0; pos < frames;) {
+        const int n = qMin(frames - pos, qMax(1, int(std::ceil(tickCountdown))));
+        for (Voice &v : voices)
+            if (!v.done && v.amp > 0) renderVoice(v, out + pos, n);
+            else if (!v.done) v.phase += v.inc * quint32(n);
+        pos += n;
+        tickCountdown -= n;
+        if (tickCountdown <= 0.0) {
+            tick();
+            tickCountdown += samplesPerTick;
+        }
+    }
+}
+
+// out[i] = sat(out[i] + (wave(phase) * amp >> 16))
+void ChipPlayer::renderVoice(Voice &v, qint16 *out, int frames)
+{
+    const ChipWave wave = v.channel->wave;
+    const qint16 amp = v.amp;
+    int i = 0;
+
+    if (wave == ChipWave::Noise) {
+        // 15-bit LFSR clocked once per oscillator period, like the NES
+        for (; i < frames; ++i) {
+            const quint32 old = v.phase;
+            v.phase += v.inc;
+            if (v.phase < old) {
+                const quint16 fb = (v.lfsr ^ (v.lfsr >> 1)) & 1;
+                v.lfsr = quint16((v.lfsr >> 1) | (fb << 14));
+            }
+            const int w = (v.lfsr & 1) ? -32768 : 32767;
+            out[i] = addSat(out[i], (w * amp) >> 16);
+        }
+        return;
+    }
+
+    const quint32 duty = dutyFor(wave);
+#ifdef __SSE2__
+    const __m128i bias = _mm_set1_epi32(int(0x80000000u));
+    const __m128i dutyB = _mm_set1_epi32(int(duty ^ 0x80000000u));
+    const __m128i signFlip = _mm_set1_epi32(-32768);
+    const __m128i half = _mm_set1_epi32(32768);
+    const __m128i gain = _mm_set1_epi16(amp);
+    const __m128i step4 = _mm_set1_epi32(int(v.inc * 4));
+    __m128i p = _mm_setr_epi32(int(v.phase), int(v.phase + v.inc),
+                               int(v.phase + 2 * v.inc), int(v.phase + 3 * v.inc));
+    for (; i + 8 <= frames; i += 8) {
+        __m128i w[2];
+        for (int h = 0; h < 2; ++h) {
+            if (wave == ChipWave::Triangle) {
+                const __m128i folded = _mm_xor_si128(p, _mm_srai_epi32(p, 31));
+                w[h] = _mm_sub_epi32(_mm_srli_epi32(folded, 15), half);
+            } else {
+                // unsigned phase < duty via a biased signed compare
+                const __m128i lt = _mm_cmplt_epi32(_mm_xor_si128(p, bias), dutyB);
+                w[h] = _mm_xor_si128(lt, signFlip);
+            }
+            p = _mm_add_epi32(p, step4);
+        }
+        const __m128i s = _mm_mulhi_epi16(_mm_packs_epi32(w[0], w[1]), gain);
+        __m128i *dst = reinterpret_cast<__m128i *>(out + i);
+        _mm_storeu_si128(dst, _mm_adds_epi16(_mm_loadu_si128(dst), s));
+        v.phase += v.inc * 8;
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] = addSat(out[i], (waveSample(wave, v.phase, duty) * amp) >> 16);
+        v.phase += v.inc;
+    }
+}
+
+QVector<qint16> ChipPlayer::renderClip(const ChipSong &song, int sampleRate)
+{
+    int longest = 0;
+    for (int c = 0; c < song.channelCount; ++c) {
+        int ticks = 0;
+        for (int n = 0; n < song.channels[c].noteCount; ++n)
+            ticks += qMax(1, int(song.channels[c].notes[n].ticks));
+        longest = qMax(longest, ticks);
+    }
+    const int total = int((qint64(longest) + 1) * sampleRate / qMax(1, song.tickHz));
+
+    ChipPlayer player(sampleRate);
+    player.setSong(&song);
+    QVector<qint16> pcm(total);
+    int done = 0;
+    while (done < total && !player.isFinished()) {
+        const int n = qMin(1024, total - done);
+        player.render(pcm.data() + done, n);
+        done += n;
+    }
+    pcm.resize(done);
+    return pcm;
+}
+
+// ==============================
+// 🎼 SONG DATA
+// ==============================
+
+namespace ChipSongs {
+
+namespace {
+
+// Two-note blip per pellet
+const ChipNote eatLead[] = { {67, 3}, {72, 3} };
+const ChipChannel eatChannels[] = {
+    { ChipWave::Pulse50, 10, 24, 0, eatLead, 2 },
+};
+
+// Sliding descent, then a thud of noise
+const ChipNote deathLead[] = {
+    {79, 10}, {76, 10}, {72, 10}, {67, 10}, {64, 10}, {60, 20},
+};
+const ChipNote deathNoise[] = { {0, 70}, {100, 12} };
+const ChipChannel deathChannels[] = {
+    { ChipWave::Pulse25, 12, 2, -40, deathLead, 6 },
+    { ChipWave::Noise, 8, 8, 0, deathNoise, 2 },
+};
+
+// Major arpeggio fanfare
+const ChipNote winLead[] = { {72, 6}, {76, 6}, {79, 6}, {84, 24} };
+const ChipNote winHarmony[] = { {0, 3}, {76, 6}, {79, 6}, {84, 6}, {88, 21} };
+const ChipNote winBass[] = { {48, 18}, {60, 24} };
+const ChipChannel winChannels[] = {
+    { ChipWave::Pulse50, 11, 4, 0, winLead, 4 },
+    { ChipWave::Pulse25, 7, 4, 0, winHarmony, 5 },
+    { ChipWave::Triangle, 10, 0, 0, winBass, 2 },
+};
+
+// Four bars in C minor: Cm, Ab, Bb, G. 7 ticks per 16th at 60 Hz.
+const ChipNote themeLead[] = {
+    {72, 7}, {0, 7}, {75, 7}, {77, 7}, {79, 14}, {77, 7}, {75, 7},
+    {72, 14}, {70, 7}, {72, 7}, {75, 28},
+    {72, 7}, {0, 7}, {75, 7}, {77, 7}, {79, 14}, {82, 7}, {79, 7},
+    {77, 14}, {75, 7}, {77, 7}, {79, 28},
+    {82, 14}, {79, 7}, {77, 7}, {79, 14}, {77, 7}, {75, 7},
+    {77, 14}, {75, 7}, {74, 7}, {70, 28},
+    {71, 14}, {74, 7}, {77, 7}, {79, 14}, {77, 7}, {74, 7},
+    {71, 14}, {67, 7}, {71, 7}, {74, 14}, {0, 14},
+};
+const ChipNote themeBass[] = {
+    {48, 26}, {0, 2}, {60, 26}, {0, 2}, {48, 26}, {0, 2}, {60, 26}, {0, 2},
+    {44, 26}, {0, 2}, {56, 26}, {0, 2}, {44, 26}, {0, 2}, {56, 26}, {0, 2},
+    {46, 26}, {0, 2}, {58, 26}, {0, 2}, {46, 26}, {0, 2}, {58, 26}, {0, 2},
+    {43, 26}, {0, 2}, {55, 26}, {0, 2}, {43, 26}, {0, 2}, {55, 26}, {0, 2},
+};
+const ChipNote themeHat[] = { {110, 2}, {0, 12} };
+const ChipChannel themeChannels[] = {
+    { ChipWave::Pulse25, 6, 6, 0, themeLead, int(std::size(themeLead)) },
+    { ChipWave::Triangle, 12, 0, 0, themeBass, int(std::size(themeBass)) },
+    { ChipWave::Noise, 4, 32, 0, themeHat, int(std::size(themeHat)) },
+};
+
+} // namespace
+
+const ChipSong &eat()
+{
+    static const ChipSong s{ 60, false, eatChannels, int(std::size(eatChannels)) };
+    return s;
+}
+
+const ChipSong &death()
+{
+    static const ChipSong s{ 60, false, deathChannels, int(std::size(deathChannels)) };
+    return s;
+}
+
+const ChipSong &win()
+{
+    static const ChipSong s{ 60, false, winChannels, int(std::size(winChannels)) };
+    return s;
+}
+
+const ChipSong &theme()
+{
+    static const ChipSong s{ 60, true, themeChannels, int(std::size(themeChannels)) };
+    return s;
+}
+
+} // namespace ChipSongs
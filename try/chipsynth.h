@@ -0,0 +1,96 @@
+#ifndef CHIPSYNTH_H
+#define CHIPSYNTH_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// ==============================
+// 🎹 CHIPTUNE SYNTH
+// ==============================
+
+// A tiny NES-style synth: pulse (12.5/25/50% duty), triangle and LFSR
+// noise oscillators driven by compact note lists. Every sound in the game
+// is a ChipSong, so there is nothing to decode and nothing to ship.
+
+enum class ChipWave : quint8 { Pulse12, Pulse25, Pulse50, Triangle, Noise };
+
+// key: MIDI note number, 0 = rest. ticks: length at the song's tick rate.
+struct ChipNote {
+    quint8 key;
+    quint8 ticks;
+};
+
+struct ChipChannel {
+    ChipWave wave;
+    quint8 volume;        // 0..15
+    quint8 decay;         // volume lost per tick, in 1/16 steps (0 = hold)
+    qint16 sweepCents;    // pitch slide per tick
+    const ChipNote *notes;
+    int noteCount;
+};
+
+struct ChipSong {
+    int tickHz;           // sequencer rate, 60 like the old consoles
+    bool loop;            // each channel wraps on its own when true
+    const ChipChannel *channels;
+    int channelCount;
+};
+
+// Plays one song at a fixed sample rate into a mono 16-bit buffer. Not
+// thread-safe; the owner serialises access.
+class ChipPlayer
+{
+public:
+    static constexpr int kMaxChannels = 4;
+
+    explicit ChipPlayer(int sampleRate = 48000);
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return rate; }
+
+    // Restarts from the top; nullptr silences the player
+    void setSong(const ChipSong *song);
+    bool isFinished() const;
+
+    // Overwrites out[0..frames) with the mix of every channel
+    void render(qint16 *out, int frames);
+
+    // Whole song, start to end, for one-shot effects. Looping songs are
+    // cut after one pass of their longest channel.
+    static QVector<qint16> renderClip(const ChipSong &song, int sampleRate);
+
+private:
+    struct Voice {
+        const ChipChannel *channel = nullptr;
+        int note = 0;
+        int ticksLeft = 0;
+        bool done = true;
+        quint32 phase = 0;
+        quint32 inc = 0;
+        int env = 0;          // volume << 4
+        qint16 amp = 0;       // Q15 of env
+        quint16 lfsr = 1;
+        double sweep = 1.0;
+    };
+
+    void startNote(Voice &v);
+    void tick();
+    static void renderVoice(Voice &v, qint16 *out, int frames);
+
+    int rate;
+    quint32 keyInc[128];
+    const ChipSong *song = nullptr;
+    Voice voices[kMaxChannels];
+    double samplesPerTick = 0.0;
+    double tickCountdown = 0.0;
+};
+
+// Built-in effects and background theme
+namespace ChipSongs {
+const ChipSong &eat();
+const ChipSong &death();
+const ChipSong &win();
+const ChipSong &theme();
+}
+
+#endif // CHIPSYNTH_H
@@ -0,0 +1,408 @@
+#include "chunkedworld.h"
+#include <QDebug>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN,
+              "chunk rows are copied straight into BitGrid bytes");
+
+namespace {
+
+constexpr char kMagic[4] = { 'P', 'M', 'C', 'W' };
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderSize = 64;
+constexpr int kNameOffset = 32;
+constexpr int kNameSize = 32;
+constexpr int kIndexEntrySize = 16;
+constexpr int kSide = ChunkedWorld::kChunkSide;
+constexpr int kRowBytes = kSide / 8;
+
+inline quint16 u16(const uchar *p) { return qFromLittleEndian<quint16>(p); }
+inline quint32 u32(const uchar *p) { return qFromLittleEndian<quint32>(p); }
+
+// Cells x0..x0+63 of row y; cells off the grid read as `outside`
+quint64 rowWord(const BitGrid &g, int x0, int y, bool outside)
+{
+    if (y >= g.rows())
+        return outside ? ~quint64(0) : 0;
+    quint64 word = 0;
+    const int from = x0 / 8;
+    std::memcpy(&word, g.constBits() + qsizetype(y) * g.stride() + from, qMin(kRowBytes, g.stride() - from));
+    const int inside = g.cols() - x0;
+    if (inside < kSide) {
+        const quint64 off = ~quint64(0) << inside;
+        word = outside ? word | off : word & ~off;
+    }
+    return word;
+}
+
+} // namespace
+
+ChunkedWorld::ChunkedWorld()
+{
+    loader.setMaxThreadCount(1);
+}
+
+ChunkedWorld::~ChunkedWorld()
+{
+    close();
+}
+
+// ----- writer -----
+bool ChunkedWorld::write(const QString &path, const LevelData &level, QString *error)
+{
+    auto fail = [error](const QString &why) {
+        if (error) *error = why;
+        return false;
+    };
+
+    const BitGrid &walls = level.walls;
+    const int cols = walls.cols(), rows = walls.rows();
+    if (walls.isEmpty() || cols > LevelPack::kMaxSide || rows > LevelPack::kMaxSide)
+        return fail(QString("bad size %1x%2").arg(cols).arg(rows));
+    if (!walls.contains(level.playerStart.x(), level.playerStart.y()))
+        return fail("spawn outside the board");
+    const bool compiled = level.isCompiled();
+    const int cx = (cols + kSide - 1) / kSide, cy = (rows + kSide - 1) / kSide;
+
+    QByteArray head(kHeaderSize + level.enemies.size() * LevelPack::kEnemyRecordSize, '\0');
+    for (int e = 0; e < level.enemies.size(); ++e)
+        LevelPack::writeEnemy(level.enemies[e], head.data() + kHeaderSize + e * LevelPack::kEnemyRecordSize);
+    head.append(QByteArray((8 - head.size() % 8) % 8, '\0'));
+    QByteArray index(cx * cy * kIndexEntrySize, '\0');
+
+    // Chunks row by row, each compressed on its own so it can be loaded alone
+    const qint64 dataAt = head.size() + index.size();
+    QByteArray blobs;
+    quint32 pelletCount = 0;
+    Chunk c;
+    for (int gy = 0; gy < cy; ++gy) {
+        for (int gx = 0; gx < cx; ++gx) {
+            for (int r = 0; r < kSide; ++r) {
+                const int y = gy * kSide + r;
+                c.walls[r] = rowWord(walls, gx * kSide, y, true);
+                c.food[r] = compiled ? rowWord(level.food, gx * kSide, y, false) : ~c.walls[r];
+            }
+            const QPoint spawn = level.playerStart - QPoint(gx * kSide, gy * kSide);
+            if (!compiled && uint(spawn.x()) < uint(kSide) && uint(spawn.y()) < uint(kSide))
+                c.food[spawn.y()] &= ~(quint64(1) << spawn.x());
+            for (quint64 word : c.food)
+                pelletCount += qPopulationCount(word);
+
+            const QByteArray blob = qCompress(reinterpret_cast<const uchar *>(&c), int(sizeof(Chunk)));
+            char *entry = index.data() + (gy * cx + gx) * kIndexEntrySize;
+            qToLittleEndian<quint64>(quint64(dataAt + blobs.size()), entry);
+            qToLittleEndian<quint32>(quint32(blob.size()), entry + 8);
+            blobs += blob;
+        }
+    }
+
+    char *h = head.data();
+    std::memcpy(h, kMagic, 4);
+    qToLittleEndian<quint16>(kVersion, h + 4);
+    qToLittleEndian<quint16>(quint16(kSide), h + 6);
+    qToLittleEndian<quint16>(quint16(cols), h + 8);
+    qToLittleEndian<quint16>(quint16(rows), h + 10);
+    qToLittleEndian<quint16>(quint16(level.playerStart.x()), h + 12);
+    qToLittleEndian<quint16>(quint16(level.playerStart.y()), h + 14);
+    qToLittleEndian<quint32>(quint32(level.enemies.size()), h + 16);
+    qToLittleEndian<quint32>(pelletCount, h + 20);
+    qToLittleEndian<quint32>(quint32(cx * cy), h + 24);
+    const QByteArray name = level.name.toUtf8().left(kNameSize);
+    std::memcpy(h + kNameOffset, name.constData(), name.size());
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        return fail(f.errorString());
+    if (f.write(head) != head.size() || f.write(index) != index.size() || f.write(blobs) != blobs.size())
+        return fail(f.errorString());
+    if (!f.commit())
+        return fail(f.errorString());
+    return true;
+}
+
+// ----- reader -----
+bool ChunkedWorld::open(const QString &path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    length = file.size();
+    base = length >= kHeaderSize ? file.map(0, length) : nullptr;
+    if (!base) {
+        close();
+        return false;
+    }
+
+    const int cols = u16(base + 8), rows = u16(base + 10);
+    const quint32 enemyCount = u32(base + 16), count = u32(base + 24);
+    const quint64 tableAt = (kHeaderSize + quint64(enemyCount) * LevelPack::kEnemyRecordSize + 7) & ~quint64(7);
+    if (std::memcmp(base, kMagic, 4) != 0 || u16(base + 4) != kVersion || u16(base + 6) != kSide
+        || cols < 1 || rows < 1 || cols > LevelPack::kMaxSide || rows > LevelPack::kMaxSide
+        || u16(base + 12) >= cols || u16(base + 14) >= rows     // spawn, as write() insists
+        || count != quint32(((cols + kSide - 1) / kSide) * ((rows + kSide - 1) / kSide))
+        || tableAt + quint64(count) * kIndexEntrySize > quint64(length)) {
+        close();
+        return false;
+    }
+
+    info = LevelData();
+    info.enemies.reserve(int(enemyCount));
+    for (quint32 i = 0; i < enemyCount; ++i) {
+        const Enemy en = LevelPack::readEnemy(base + kHeaderSize + i * LevelPack::kEnemyRecordSize);
+        if (en.x >= cols || en.y >= rows || qAbs(en.dx) > 1 || qAbs(en.dy) > 1) {
+            close();
+            return false;
+        }
+        info.enemies.append(en);
+    }
+    const char *name = reinterpret_cast<const char *>(base + kNameOffset);
+    info.name = QString::fromUtf8(name, int(qstrnlen(name, kNameSize)));
+    info.playerStart = QPoint(u16(base + 12), u16(base + 14));
+
+    w = cols;
+    h = rows;
+    chunksX = (cols + kSide - 1) / kSide;
+    chunksY = (rows + kSide - 1) / kSide;
+    table = base + tableAt;
+    filePellets = pellets = int(u32(base + 20));
+    slots = std::vector<Slot>(count);
+    return true;
+}
+
+void ChunkedWorld::close()
+{
+    // Loads read the mapping; let them finish first
+    loader.clear();
+    loader.waitForDone();
+    Loaded l;
+    while (loaded.pop(l))
+        delete l.chunk;
+    inFlight = 0;
+
+    slots.clear();
+    lruHead = lruTail = -1;
+    resident = 0;
+    eatenBytes = 0;
+    counters = Stats();
+    if (base)
+        file.unmap(const_cast<uchar *>(base));
+    file.close();
+    base = nullptr;
+    table = nullptr;
+    length = 0;
+    w = h = chunksX = chunksY = 0;
+    filePellets = pellets = 0;
+    info = LevelData();
+}
+
+void ChunkedWorld::reset()
+{
+    for (Slot &s : slots) {
+        s.chunk.reset();
+        s.eaten = QByteArray();
+        s.prev = s.next = -1;
+        s.loading = false;
+        s.dirty = false;
+    }
+    lruHead = lruTail = -1;
+    resident = 0;
+    eatenBytes = 0;
+    pellets = filePellets;
+    ++epoch;
+}
+
+// ======== STREAMING ========
+
+// Loader thread. Only reads the mapping, which outlives every load.
+ChunkedWorld::Chunk *ChunkedWorld::decode(int i, const QByteArray &eaten) const
+{
+    Chunk *c = new Chunk;
+    const uchar *entry = table + qsizetype(i) * kIndexEntrySize;
+    const quint64 offset = qFromLittleEndian<quint64>(entry);
+    const quint32 size = u32(entry + 8);
+    QByteArray raw;
+    if (offset <= quint64(length) && size <= quint64(length) - offset)
+        raw = qUncompress(base + offset, qsizetype(size));
+
+    // A broken chunk is walled off rather than failing the whole board
+    if (raw.size() != qsizetype(sizeof(Chunk))) {
+        qWarning() << "world: chunk" << i << "is corrupt, walling it off";
+        std::fill(std::begin(c->walls), std::end(c->walls), ~quint64(0));
+        std::fill(std::begin(c->food), std::end(c->food), quint64(0));
+        return c;
+    }
+    std::memcpy(c, raw.constData(), sizeof(Chunk));
+    if (!eaten.isEmpty()) {
+        const QByteArray food = qUncompress(eaten);
+        if (food.size() == qsizetype(sizeof(c->food)))
+            std::memcpy(c->food, food.constData(), sizeof(c->food));
+    }
+    return c;
+}
+
+void ChunkedWorld::request(int i)
+{
+    Slot &s = slots[i];
+    s.loading = true;
+    ++inFlight;
+    const QByteArray eaten = s.eaten;
+    const quint32 e = epoch;
+    loader.start([this, i, eaten, e]() {
+        // Never full: at most kMaxLoadsInFlight are out at once
+        loaded.push(Loaded{ i, e, decode(i, eaten) });
+    });
+}
+
+void ChunkedWorld::adopt()
+{
+    Loaded l;
+    while (loaded.pop(l)) {
+        --inFlight;
+        std::unique_ptr<Chunk> chunk(l.chunk);
+        Slot &s = slots[l.index];
+        if (l.epoch != epoch || !s.loading)
+            continue;
+        s.loading = false;
+        s.chunk = std::move(chunk);
+        s.dirty = !s.eaten.isEmpty();
+        eatenBytes -= s.eaten.size();
+        s.eaten = QByteArray();
+        link(l.index);
+        ++counters.loads;
+    }
+}
+
+void ChunkedWorld::update(const QVector<QRect> &wanted)
+{
+    if (!base)
+        return;
+    ++updates;
+    adopt();
+
+    // Wanted chunks move to the front of the LRU list
+    const QRect board(0, 0, w, h);
+    for (const QRect &area : wanted) {
+        const QRect cells = area & board;
+        if (cells.isEmpty())
+            continue;
+        for (int cy = cells.top() / kSide; cy <= cells.bottom() / kSide; ++cy)
+            for (int cx = cells.left() / kSide; cx <= cells.right() / kSide; ++cx) {
+                const int i = cy * chunksX + cx;
+                Slot &s = slots[i];
+                if (s.wantedAt == updates)
+                    continue;
+                s.wantedAt = updates;
+                if (s.chunk) {
+                    if (lruHead != i) {
+                        unlink(i);
+                        link(i);
+                    }
+                } else {
+                    ++counters.misses;
+                    if (!s.loading && inFlight < kMaxLoadsInFlight)
+                        request(i);
+                }
+            }
+    }
+
+    // Everything wanted this update sits in front, so stop at the first one
+    while (lruTail >= 0 && residentBytes() > cap && slots[lruTail].wantedAt != updates)
+        evict(lruTail);
+    counters.peakBytes = qMax(counters.peakBytes, residentBytes());
+}
+
+void ChunkedWorld::evict(int i)
+{
+    Slot &s = slots[i];
+    unlink(i);
+    if (s.dirty) {
+        s.eaten = qCompress(reinterpret_cast<const uchar *>(s.chunk->food), int(sizeof(s.chunk->food)));
+        eatenBytes += s.eaten.size();
+    }
+    s.chunk.reset();
+    s.dirty = false;
+    ++counters.evictions;
+}
+
+void ChunkedWorld::link(int i)
+{
+    Slot &s = slots[i];
+    s.prev = -1;
+    s.next = lruHead;
+    if (lruHead >= 0)
+        slots[lruHead].prev = i;
+    lruHead = i;
+    if (lruTail < 0)
+        lruTail = i;
+    ++resident;
+}
+
+void ChunkedWorld::unlink(int i)
+{
+    Slot &s = slots[i];
+    if (s.prev >= 0) slots[s.prev].next = s.next;
+    else lruHead = s.next;
+    if (s.next >= 0) slots[s.next].prev = s.prev;
+    else lruTail = s.prev;
+    s.prev = s.next = -1;
+    --resident;
+}
+
+// ======== CELLS ========
+
+bool ChunkedWorld::eat(int x, int y)
+{
+    if (!hasFood(x, y))
+        return false;
+    Slot &s = slots[size_t(y / kSide) * chunksX + x / kSide];
+    s.chunk->food[y % kSide] &= ~(quint64(1) << (x % kSide));
+    s.dirty = true;
+    --pellets;
+    return true;
+}
+
+QPoint ChunkedWorld::copyRegion(const QRect &area, BitGrid *walls, BitGrid *food) const
+{
+    const QRect cells = area & QRect(0, 0, w, h);
+    if (cells.isEmpty()) {
+        *walls = BitGrid();
+        *food = BitGrid();
+        return QPoint();
+    }
+
+    // Whole chunks, so every chunk row is one aligned 8-byte copy
+    const int cx0 = cells.left() / kSide, cx1 = cells.right() / kSide;
+    const int cy0 = cells.top() / kSide, cy1 = cells.bottom() / kSide;
+    BitGrid wallGrid((cx1 - cx0 + 1) * kSide, (cy1 - cy0 + 1) * kSide);
+    BitGrid foodGrid(wallGrid.cols(), wallGrid.rows());
+    uchar *wallBits = wallGrid.bits();
+    uchar *foodBits = foodGrid.bits();
+    const qsizetype stride = wallGrid.stride();
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            const Chunk *c = slots[size_t(cy) * chunksX + cx].chunk.get();
+            if (!c)
+                continue;
+            const qsizetype at = qsizetype(cy - cy0) * kSide * stride + (cx - cx0) * kRowBytes;
+            for (int r = 0; r < kSide; ++r) {
+                std::memcpy(wallBits + at + r * stride, &c->walls[r], kRowBytes);
+                std::memcpy(foodBits + at + r * stride, &c->food[r], kRowBytes);
+            }
+        }
+    *walls = wallGrid;
+    *food = foodGrid;
+    return QPoint(cx0 * kSide, cy0 * kSide);
+}
+
+ChunkedWorld::Stats ChunkedWorld::stats() const
+{
+    Stats s = counters;
+    s.resident = resident;
+    s.loading = inFlight;
+    s.bytes = residentBytes();
+    return s;
+}
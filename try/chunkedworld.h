@@ -0,0 +1,181 @@
+#ifndef CHUNKEDWORLD_H
+#define CHUNKEDWORLD_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+#include "levelpack.h"
+#include "spscring.h"
+
+// ==============================
+// 🧩 CHUNKED WORLD
+// ==============================
+
+// A board too big to keep whole, split into kChunkSide x kChunkSide
+// chunks of walls and pellets. Chunks live compressed in a mapped world
+// file and only the ones around Pac-Man are unpacked.
+//
+// Once per tick the simulation says which areas it wants. Wanted chunks
+// that are missing are decompressed on a loader thread and handed back
+// through a lock-free ring; the tick never waits for one. Until a chunk
+// is in, its cells read as wall without food, so nothing walks into the
+// unknown. Past the memory cap the least recently wanted chunks go first;
+// one with pellets eaten keeps them as a compressed bitmap of its own.
+//
+// World file (little endian):
+//   "PMCW", u16 version, u16 chunk side, u16 cols, u16 rows,
+//   u16 playerX, u16 playerY, u32 enemyCount, u32 pellets,
+//   u32 chunkCount, u32 0, char name[32] (UTF-8, NUL padded)
+//   enemyCount x LevelPack enemy record
+//   chunkCount x { u64 offset, u32 size, u32 0 }, row-major chunks
+//   chunks, each qCompress()ed kChunkSide x u64 walls, then pellets
+//
+// Everything but write() belongs to the simulation thread.
+class ChunkedWorld
+{
+public:
+    static constexpr int kChunkSide = 64;   // one quint64 per chunk row
+    static constexpr qint64 kChunkBytes = 2 * kChunkSide * qint64(sizeof(quint64));
+
+    // A 4096x4096 board is 4096 chunks, 4 MB unpacked; what is streamed
+    // around Pac-Man is a hundred or so
+    static constexpr qint64 kDefaultMemoryCap = qint64(1) << 20;
+    static constexpr int kMaxLoadsInFlight = 64;
+
+    struct Stats {
+        int resident = 0;           // chunks unpacked
+        int loading = 0;
+        qint64 bytes = 0;           // resident chunks plus saved pellets
+        qint64 peakBytes = 0;       // most bytes left after any update()
+        qint64 loads = 0;
+        qint64 evictions = 0;
+        qint64 misses = 0;          // wanted chunk not in yet, over all updates
+    };
+
+    ChunkedWorld();
+    ~ChunkedWorld();
+
+    ChunkedWorld(const ChunkedWorld &) = delete;
+    ChunkedWorld &operator=(const ChunkedWorld &) = delete;
+
+    // Pellets come from level.food when it is compiled, else every open
+    // cell but the spawn. Any thread.
+    static bool write(const QString &path, const LevelData &level, QString *error = nullptr);
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int cols() const { return w; }
+    int rows() const { return h; }
+
+    // Name, spawn and enemies; walls and the rest stay in the chunks
+    const LevelData &head() const { return info; }
+
+    // Pellets left on the whole board
+    int foodLeft() const { return pellets; }
+
+    // Takes effect at the next update()
+    void setMemoryCap(qint64 bytes) { cap = qMax<qint64>(0, bytes); }
+    qint64 memoryCap() const { return cap; }
+
+    // Back to the pellets in the file; chunks are loaded again as wanted
+    void reset();
+
+    // Once per tick: takes in finished loads, keeps every chunk touching
+    // `wanted` (requesting the missing ones) and evicts down to the cap.
+    void update(const QVector<QRect> &wanted);
+
+    // Cells outside the board, or in a chunk not in yet, are wall
+    bool isWall(int x, int y) const
+    {
+        if (uint(x) >= uint(w) || uint(y) >= uint(h)) return true;
+        const Chunk *c = chunkAt(x, y);
+        return !c || (c->walls[y % kChunkSide] >> (x % kChunkSide)) & 1;
+    }
+
+    bool hasFood(int x, int y) const
+    {
+        if (uint(x) >= uint(w) || uint(y) >= uint(h)) return false;
+        const Chunk *c = chunkAt(x, y);
+        return c && (c->food[y % kChunkSide] >> (x % kChunkSide)) & 1;
+    }
+
+    // True if there was a pellet
+    bool eat(int x, int y);
+
+    // Walls and pellets of the chunks under area, as grids starting at
+    // the returned cell. Chunks not in yet come out empty.
+    QPoint copyRegion(const QRect &area, BitGrid *walls, BitGrid *food) const;
+
+    Stats stats() const;
+
+private:
+    struct Chunk {
+        quint64 walls[kChunkSide];
+        quint64 food[kChunkSide];
+    };
+    static_assert(sizeof(Chunk) == kChunkBytes, "chunk layout");
+
+    struct Slot {
+        std::unique_ptr<Chunk> chunk;
+        QByteArray eaten;           // qCompress()ed food of an evicted chunk
+        int prev = -1, next = -1;   // LRU list, resident slots only
+        quint32 wantedAt = 0;       // update() that last wanted it
+        bool loading = false;
+        bool dirty = false;         // food differs from the file
+    };
+
+    struct Loaded {
+        int index = -1;
+        quint32 epoch = 0;
+        Chunk *chunk = nullptr;
+    };
+
+    const Chunk *chunkAt(int x, int y) const
+    {
+        return slots[size_t(y / kChunkSide) * chunksX + x / kChunkSide].chunk.get();
+    }
+
+    Chunk *decode(int index, const QByteArray &eaten) const;
+    void request(int index);
+    void adopt();
+    void evict(int index);
+    void link(int index);
+    void unlink(int index);
+    qint64 residentBytes() const { return resident * kChunkBytes + eatenBytes; }
+
+    QFile file;
+    const uchar *base = nullptr;
+    qint64 length = 0;
+    const uchar *table = nullptr;      // chunk index in the mapping
+
+    int w = 0, h = 0;
+    int chunksX = 0, chunksY = 0;
+    int filePellets = 0;
+    int pellets = 0;
+    LevelData info;
+
+    std::vector<Slot> slots;
+    int lruHead = -1, lruTail = -1;   // most and least recently wanted
+    int resident = 0;
+    int inFlight = 0;                 // requested, not yet taken from the ring
+    quint32 updates = 0;
+    quint32 epoch = 0;                // bumped by reset(); older loads are dropped
+    qint64 cap = kDefaultMemoryCap;
+    qint64 eatenBytes = 0;
+    Stats counters;
+
+    // One loader thread, so the ring has a single producer
+    QThreadPool loader;
+    SpscRing<Loaded> loaded{kMaxLoadsInFlight};
+};
+
+#endif // CHUNKEDWORLD_H
@@ -0,0 +1,150 @@
+#include "crtfilter.h"
+#include <QtMath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Every third row gets darkened, like the old CRTOverlay lines did.
+constexpr int kScanlinePeriod = 3;
+constexpr double kScanlineLevel = 0.86;
+constexpr double kVignette = 0.22;
+constexpr double kBarrel = 0.08;
+
+constexpr QRgb kOffScreen = 0xff000000;
+
+} // namespace
+
+void CrtFilter::setCurvature(bool on)
+{
+    if (curved == on) return;
+    curved = on;
+    dirty = true;
+}
+
+void CrtFilter::prepare(const QSize &size)
+{
+    if (!dirty && size == cachedSize)
+        return;
+    cachedSize = size;
+    dirty = false;
+
+    const int w = size.width();
+    const int h = size.height();
+    const double sx = 2.0 / qMax(1, w - 1);
+    const double sy = 2.0 / qMax(1, h - 1);
+
+    weights.resize(w * h);
+    for (int y = 0; y < h; ++y) {
+        const double v = y * sy - 1.0;
+        const double scan = (y % kScanlinePeriod == 0) ? kScanlineLevel : 1.0;
+        const double vigY = 1.0 - kVignette * v * v;
+        for (int x = 0; x < w; ++x) {
+            const double u = x * sx - 1.0;
+            const double vig = (1.0 - kVignette * u * u) * vigY;
+            weights[y * w + x] = uchar(qBound(0, qRound(255.0 * scan * vig), 255));
+        }
+    }
+
+    remap.clear();
+    if (!curved)
+        return;
+
+    remap.resize(w * h);
+    for (int y = 0; y < h; ++y) {
+        const double v = y * sy - 1.0;
+        for (int x = 0; x < w; ++x) {
+            const double u = x * sx - 1.0;
+            const double su = u * (1.0 + kBarrel * v * v);
+            const double sv = v * (1.0 + kBarrel * u * u);
+            const int srcX = qRound((su + 1.0) / sx);
+            const int srcY = qRound((sv + 1.0) / sy);
+            remap[y * w + x] = (srcX < 0 || srcY < 0 || srcX >= w || srcY >= h)
+                                   ? -1 : srcY * w + srcX;
+        }
+    }
+}
+
+void CrtFilter::apply(const QImage &src, uchar *dstBits, qsizetype dstBpl,
+                      int y0, int y1) const
+{
+    const int w = cachedSize.width();
+    if (w <= 0) return;
+
+    // One pixel of edge padding on each side keeps the bloom taps branch-free.
+    QVector<QRgb> padded(w + 2);
+    const QRgb *srcPixels = reinterpret_cast<const QRgb *>(src.constBits());
+
+    for (int y = y0; y < y1; ++y) {
+        QRgb *row = padded.data() + 1;
+        if (remap.isEmpty()) {
+            std::memcpy(row, srcPixels + y * w, w * sizeof(QRgb));
+        } else {
+            const qint32 *map = remap.constData() + y * w;
+            for (int x = 0; x < w; ++x)
+                row[x] = map[x] < 0 ? kOffScreen : srcPixels[map[x]];
+        }
+        padded[0] = row[0];
+        padded[w + 1] = row[w - 1];
+
+        filterRow(padded.constData(), weights.constData() + y * w,
+                  reinterpret_cast<QRgb *>(dstBits + y * dstBpl), w);
+    }
+}
+
+// out = c * weight + max(0, avg(left, right) - c) / 2, per channel.
+// Alpha keeps a weight of 255 so RGB32 stays opaque.
+void CrtFilter::filterRow(const QRgb *padded, const uchar *weight, QRgb *out, int w) const
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+    for (; x + 4 <= w; x += 4) {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + x));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + x + 1));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + x + 2));
+        const __m128i glow = _mm_subs_epu8(_mm_avg_epu8(l, r), c);
+
+        int packed;
+        std::memcpy(&packed, weight + x, sizeof(packed));
+        __m128i wv = _mm_cvtsi32_si128(packed);
+        wv = _mm_unpacklo_epi8(wv, wv);
+        wv = _mm_unpacklo_epi16(wv, wv);
+        wv = _mm_or_si128(wv, alpha);
+
+        const __m128i cLo = _mm_unpacklo_epi8(c, zero);
+        const __m128i cHi = _mm_unpackhi_epi8(c, zero);
+        const __m128i wLo = _mm_unpacklo_epi8(wv, zero);
+        const __m128i wHi = _mm_unpackhi_epi8(wv, zero);
+        const __m128i gLo = _mm_srli_epi16(_mm_unpacklo_epi8(glow, zero), 1);
+        const __m128i gHi = _mm_srli_epi16(_mm_unpackhi_epi8(glow, zero), 1);
+
+        // (c * w + c) >> 8 == c * (w + 1) / 256, exact for w == 255
+        const __m128i oLo = _mm_add_epi16(
+            _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(cLo, wLo), cLo), 8), gLo);
+        const __m128i oHi = _mm_add_epi16(
+            _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(cHi, wHi), cHi), 8), gHi);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(oLo, oHi));
+    }
+#endif
+
+    for (; x < w; ++x) {
+        const QRgb l = padded[x], c = padded[x + 1], r = padded[x + 2];
+        const int wt = weight[x];
+        QRgb o = 0xff000000;
+        for (int shift = 0; shift < 24; shift += 8) {
+            const int cc = (c >> shift) & 0xff;
+            const int avg = (((l >> shift) & 0xff) + ((r >> shift) & 0xff) + 1) >> 1;
+            const int glow = qMax(0, avg - cc) >> 1;
+            const int v = qMin(255, ((cc * wt + cc) >> 8) + glow);
+            o |= QRgb(v) << shift;
+        }
+        out[x] = o;
+    }
+}
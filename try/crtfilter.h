@@ -0,0 +1,44 @@
+#ifndef CRTFILTER_H
+#define CRTFILTER_H
+
+#include <QImage>
+#include <QSize>
+#include <QVector>
+
+// ==============================
+// 📺 CRT POST-PROCESSING
+// ==============================
+
+// Software CRT look applied to the finished framebuffer: scanlines,
+// vignette, a cheap horizontal phosphor bloom and optional barrel
+// curvature. Scanlines and vignette are folded into one per-pixel weight
+// table and curvature into a remap table; both are rebuilt only when the
+// frame size or settings change.
+class CrtFilter
+{
+public:
+    void setCurvature(bool on);
+    bool curvature() const { return curved; }
+
+    // Rebuilds the lookup tables if the size changed. Not thread safe –
+    // call once per frame before handing bands to apply().
+    void prepare(const QSize &size);
+
+    // Filters rows [y0, y1) of src into dst. Both images are Format_RGB32
+    // and the size passed to prepare(). Safe to call concurrently for
+    // disjoint row ranges.
+    void apply(const QImage &src, uchar *dstBits, qsizetype dstBpl,
+               int y0, int y1) const;
+
+private:
+    void filterRow(const QRgb *padded, const uchar *weight, QRgb *out, int w) const;
+
+    QSize cachedSize;
+    bool curved = false;
+    bool dirty = true;
+
+    QVector<uchar> weights;   // scanline * vignette, 0..255 per pixel
+    QVector<qint32> remap;    // source pixel index per pixel, -1 = off screen
+};
+
+#endif // CRTFILTER_H
@@ -0,0 +1,431 @@
+#include "framerenderer.h"
+#include "assetpack.h"
+#include "levelcache.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Fill a cell-sized rect, clipped to the rows owned by the current band.
+inline void fillRect(uchar *bits, qsizetype bpl, int imgW,
+                     int x0, int y0, int w, int h,
+                     int bandY0, int bandY1, uchar index)
+{
+    const int xs = qMax(x0, 0), xe = qMin(x0 + w, imgW);
+    const int ys = qMax(y0, bandY0), ye = qMin(y0 + h, bandY1);
+    if (xs >= xe) return;
+    for (int y = ys; y < ye; ++y)
+        std::memset(bits + y * bpl + xs, index, xe - xs);
+}
+
+// Copy an opaque tile, clipped to the band rows and the image width.
+inline void blitTile(uchar *bits, qsizetype bpl, int imgW,
+                     const uchar *src, int cs, int x0, int y0,
+                     int bandY0, int bandY1)
+{
+    const int xs = qMax(x0, 0), xe = qMin(x0 + cs, imgW);
+    const int ys = qMax(y0, bandY0), ye = qMin(y0 + cs, bandY1);
+    if (xs >= xe) return;
+    for (int y = ys; y < ye; ++y)
+        std::memcpy(bits + y * bpl + xs, src + (y - y0) * cs + (xs - x0), xe - xs);
+}
+
+// Top-left pixel of a sprite t of the way between two cells. Anything
+// further than one step is a respawn, which snaps instead of sliding.
+inline QPoint slide(const QPoint &from, const QPoint &to, float t, int cs)
+{
+    if (qAbs(to.x() - from.x()) > 1 || qAbs(to.y() - from.y()) > 1)
+        return to * cs;
+    return QPoint(qRound((from.x() + (to.x() - from.x()) * t) * cs),
+                  qRound((from.y() + (to.y() - from.y()) * t) * cs));
+}
+
+// Keeps the frame's pixels when they fit and are not shared with a frame
+// still on screen; otherwise writing would first copy them.
+void reuseFrame(QImage &img, int w, int h)
+{
+    if (img.width() != w || img.height() != h || img.format() != QImage::Format_RGB32
+        || !img.isDetached())
+        img = QImage(w, h, QImage::Format_RGB32);
+}
+
+} // namespace
+
+FrameRenderer::FrameRenderer()
+    : threads(1), palette(256, QColor(Qt::black).rgb()), tileCache(kTileCacheScales)
+{
+    setThreadCount(0);
+    palette[SlotWall] = QColor(Qt::darkBlue).rgb();
+    palette[SlotFood] = QColor(Qt::white).rgb();
+    palette[SlotPlayer] = QColor(Qt::yellow).rgb();
+}
+
+FrameRenderer::~FrameRenderer()
+{
+    pool.waitForDone();
+}
+
+void FrameRenderer::setThreadCount(int count)
+{
+    if (count <= 0)
+        count = QThread::idealThreadCount();
+    threads = qMax(1, count);
+    pool.setMaxThreadCount(threads);
+}
+
+void FrameRenderer::setPaletteColor(int slot, const QColor &color)
+{
+    if (slot >= 0 && slot < palette.size())
+        palette[slot] = color.rgb();
+}
+
+QColor FrameRenderer::paletteColor(int slot) const
+{
+    return (slot >= 0 && slot < palette.size()) ? QColor(palette[slot]) : QColor();
+}
+
+void FrameRenderer::setAssets(const AssetArchive *archive)
+{
+    assets = archive;
+    tileCache.clear();
+}
+
+QByteArray FrameRenderer::rasterizeTiles(int cs)
+{
+    const int area = cs * cs;
+    QByteArray bytes(kTileCount * area, char(SlotPlayer));
+    uchar *tile = reinterpret_cast<uchar *>(bytes.data());
+
+    std::memset(tile, SlotWall, area);
+
+    uchar *food = tile + area;
+    std::memset(food, SlotBackground, area);
+    const int dot = cs / 4;
+    const int off = (cs - dot) / 2;
+    for (int y = off; y < off + dot; ++y)
+        for (int x = off; x < off + dot; ++x)
+            food[y * cs + x] = SlotFood;
+
+    // Mouth wedges; the closed variant is a plain yellow block.
+    static const int dirs[5][2] = { {0,0}, {1,0}, {-1,0}, {0,1}, {0,-1} };
+    for (int i = 0; i < 5; ++i) {
+        uchar *player = tile + (2 + i) * area;
+        const int dirX = dirs[i][0], dirY = dirs[i][1];
+        for (int y = 0; y < cs; ++y)
+            for (int x = 0; x < cs; ++x) {
+                float dx = x - cs / 2.0f;
+                float dy = y - cs / 2.0f;
+                float angle = atan2(dy, dx) * 180.0f / M_PI;
+                bool cut = false;
+                if (dirX == 1 && angle > -30 && angle < 30) cut = true;
+                if (dirX == -1 && (angle > 150 || angle < -150)) cut = true;
+                if (dirY == 1 && angle > 60 && angle < 120) cut = true;
+                if (dirY == -1 && angle > -120 && angle < -60) cut = true;
+                if (cut) player[y * cs + x] = SlotBackground;
+            }
+    }
+    return bytes;
+}
+
+const FrameRenderer::TileSet *FrameRenderer::tilesFor(int cellSize)
+{
+    if (const TileSet *t = tileCache.object(cellSize))
+        return t;
+
+    TileSet *t = new TileSet;
+    t->cellSize = cellSize;
+    const qint64 area = qint64(cellSize) * cellSize;
+
+    // Baked sizes are used in place; anything else is rasterized here
+    const AssetView baked = assets
+        ? assets->find(assetVariant(AssetIds::Tiles, quint32(cellSize))) : AssetView();
+    if (baked.isValid() && baked.type == AssetType::Tiles8
+        && baked.param0 == quint32(cellSize) && baked.size == kTileCount * area)
+        t->storage = QByteArray::fromRawData(reinterpret_cast<const char *>(baked.data), baked.size);
+    else
+        t->storage = rasterizeTiles(cellSize);
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(t->storage.constData());
+    t->wall = bytes;
+    t->food = bytes + area;
+    for (int i = 0; i < 5; ++i)
+        t->player[i] = bytes + (2 + i) * area;
+    tileCache.insert(cellSize, t);
+    return t;
+}
+
+int FrameRenderer::playerTileIndex(const RenderScene &s)
+{
+    if (!s.mouthOpen) return 0;
+    if (s.playerDirX == 1)  return 1;
+    if (s.playerDirX == -1) return 2;
+    if (s.playerDirY == 1)  return 3;
+    if (s.playerDirY == -1) return 4;
+    return 0;
+}
+
+template <typename Fn>
+void FrameRenderer::forEachBand(int height, Fn &&fn)
+{
+    const int bandCount = qBound(1, threads, qMax(1, height));
+    if (bandCount == 1) {
+        fn(Band{ 0, height });
+        return;
+    }
+
+    QVector<Band> bands;
+    bands.reserve(bandCount);
+    const int step = (height + bandCount - 1) / bandCount;
+    for (int y = 0; y < height; y += step)
+        bands.append({ y, qMin(y + step, height) });
+
+    // Join before the caller moves on to the next stage.
+    QtConcurrent::blockingMap(&pool, bands, [&](const Band &b) { fn(b); });
+}
+
+QImage FrameRenderer::render(const RenderScene &scene)
+{
+    QImage img;
+    render(scene, img);
+    return img;
+}
+
+bool FrameRenderer::render(const RenderScene &scene, QImage &into)
+{
+    const int cs = scene.cellSize;
+    const int boardW = scene.cols * cs;
+    const int boardH = scene.rows * cs;
+    const int w = scene.viewport.isEmpty() ? boardW : qMin(boardW, scene.viewport.width());
+    const int h = scene.viewport.isEmpty() ? boardH : qMin(boardH, scene.viewport.height());
+    if (indexed.width() != w || indexed.height() != h)
+        indexed = QImage(w, h, QImage::Format_Indexed8);
+    if (indexed.isNull())
+        return false;
+
+    // Camera on Pac-Man, held against the board edges
+    const QPoint player = slide(QPoint(scene.playerFromX, scene.playerFromY),
+                                QPoint(scene.playerX, scene.playerY), scene.t, cs);
+    const QRect view(qBound(0, player.x() + cs / 2 - w / 2, boardW - w),
+                     qBound(0, player.y() + cs / 2 - h / 2, boardH - h), w, h);
+
+    // Slots go to the enemies in view, in board order
+    visibleEnemies.clear();
+    const bool enemiesSlide = scene.enemiesFrom && scene.enemiesFrom->size() == scene.enemies->size();
+    for (int i = 0; i < scene.enemies->size() && visibleEnemies.size() < palette.size() - SlotEnemy; ++i) {
+        const Enemy &e = (*scene.enemies)[i];
+        const QPoint to(e.x, e.y);
+        const QPoint px = slide(enemiesSlide ? (*scene.enemiesFrom)[i] : to, to, scene.t, cs);
+        if (!view.intersects(QRect(px, QSize(cs, cs))))
+            continue;
+        palette[SlotEnemy + visibleEnemies.size()] = e.color.rgb();
+        visibleEnemies.append(i);
+    }
+
+    // Looked up before fanning out; the caches themselves are not thread safe.
+    const TileSet &tiles = *tilesFor(scene.cellSize);
+    const bool partial = !scene.gridOrigin.isNull() || scene.maze->cols() != scene.cols
+        || scene.maze->rows() != scene.rows;
+    const WallLayer &layer = partial ? noWalls : wallsFor(*scene.maze, scene.cellSize);
+
+    // Detach once here; the workers only ever touch raw scanlines.
+    uchar *bits = indexed.bits();
+    const qsizetype bpl = indexed.bytesPerLine();
+
+    if (crtEnabled) {
+        forEachBand(h, [&](const Band &b) {
+            renderBand(scene, tiles, layer, view, bits, bpl, b.y0, b.y1);
+        });
+        present(into);
+        return true;
+    }
+
+    // Without the post pass each band can expand its own rows straight away.
+    reuseFrame(into, w, h);
+    uchar *outBits = into.bits();
+    const qsizetype outBpl = into.bytesPerLine();
+    forEachBand(h, [&](const Band &b) {
+        renderBand(scene, tiles, layer, view, bits, bpl, b.y0, b.y1);
+        expandBand(outBits, outBpl, b.y0, b.y1);
+    });
+    return true;
+}
+
+bool FrameRenderer::WallLayer::matches(const BitGrid &m, int cs) const
+{
+    return cs == cellSize && (!image.isNull() || direct)
+        && m.cols() == maze.cols() && m.rows() == maze.rows()
+        && (m.constBits() == maze.constBits() || m.data() == maze.data());
+}
+
+void FrameRenderer::buildWalls(WallLayer &layer, const BitGrid &maze, int cs)
+{
+    const int w = maze.cols() * cs;
+    const int h = maze.rows() * cs;
+    layer.maze = maze;
+    layer.cellSize = cs;
+    layer.direct = qint64(w) * h > kMaxWallLayerBytes;
+    if (layer.direct) {
+        layer.image = QImage();
+        return;
+    }
+    const uchar *wall = tilesFor(cs)->wall;
+    const QByteArray tile = QByteArray::fromRawData(reinterpret_cast<const char *>(wall), cs * cs);
+    if (cache) {
+        layer.image = cache->loadWalls(maze, cs, tile);
+        if (!layer.image.isNull())
+            return;
+    }
+
+    if (layer.image.width() != w || layer.image.height() != h)
+        layer.image = QImage(w, h, QImage::Format_Indexed8);
+    if (layer.image.isNull())
+        return;
+
+    uchar *bits = layer.image.bits();
+    const qsizetype bpl = layer.image.bytesPerLine();
+    forEachBand(h, [&](const Band &b) {
+        for (int y = b.y0; y < b.y1; ++y)
+            std::memset(bits + y * bpl, SlotBackground, w);
+
+        // Only the cell rows that intersect this band
+        const int lastRow = qMin(maze.rows() - 1, (b.y1 - 1) / cs);
+        for (int gy = b.y0 / cs; gy <= lastRow; ++gy)
+            for (int gx = 0; gx < maze.cols(); ++gx)
+                if (maze.test(gx, gy))
+                    blitTile(bits, bpl, w, wall, cs, gx * cs, gy * cs, b.y0, b.y1);
+    });
+    if (cache)
+        cache->storeWalls(maze, cs, tile, layer.image);
+}
+
+void FrameRenderer::prepareWalls(const BitGrid &maze, int cs)
+{
+    if (maze.isEmpty() || cs <= 0 || walls.matches(maze, cs) || nextWalls.matches(maze, cs))
+        return;
+    buildWalls(nextWalls, maze, cs);
+}
+
+const FrameRenderer::WallLayer &FrameRenderer::wallsFor(const BitGrid &maze, int cs)
+{
+    if (!walls.matches(maze, cs)) {
+        if (nextWalls.matches(maze, cs))
+            std::swap(walls, nextWalls);
+        else
+            buildWalls(walls, maze, cs);
+    }
+    return walls;
+}
+
+QImage FrameRenderer::recolor()
+{
+    QImage img;
+    recolor(img);
+    return img;
+}
+
+bool FrameRenderer::recolor(QImage &into)
+{
+    if (indexed.isNull())
+        return false;
+    present(into);
+    return true;
+}
+
+void FrameRenderer::present(QImage &into)
+{
+    const int w = indexed.width();
+    const int h = indexed.height();
+    QImage &rgb = crtEnabled ? expanded : into;
+    reuseFrame(rgb, w, h);
+    uchar *rgbBits = rgb.bits();
+    const qsizetype rgbBpl = rgb.bytesPerLine();
+    forEachBand(h, [&](const Band &b) {
+        expandBand(rgbBits, rgbBpl, b.y0, b.y1);
+    });
+
+    if (!crtEnabled)
+        return;
+
+    // Post pass reads neighbouring (and, when curved, remapped) rows, so
+    // it needs the complete frame and its own target.
+    crt.prepare(rgb.size());
+    reuseFrame(into, w, h);
+    uchar *outBits = into.bits();
+    const qsizetype outBpl = into.bytesPerLine();
+    forEachBand(h, [&](const Band &b) {
+        crt.apply(rgb, outBits, outBpl, b.y0, b.y1);
+    });
+}
+
+void FrameRenderer::expandBand(uchar *rgbBits, qsizetype rgbBpl, int y0, int y1) const
+{
+    const int w = indexed.width();
+    const uchar *src = indexed.constBits();
+    const qsizetype bpl = indexed.bytesPerLine();
+    const QRgb *pal = palette.constData();
+    for (int y = y0; y < y1; ++y) {
+        const uchar *in = src + y * bpl;
+        QRgb *out = reinterpret_cast<QRgb *>(rgbBits + y * rgbBpl);
+        for (int x = 0; x < w; ++x)
+            out[x] = pal[in[x]];
+    }
+}
+
+void FrameRenderer::renderBand(const RenderScene &s, const TileSet &tiles, const WallLayer &walls,
+                               const QRect &view, uchar *bits, qsizetype bpl, int y0, int y1) const
+{
+    const int cs = s.cellSize;
+    const int imgW = view.width();
+    const int ox = view.x(), oy = view.y();
+    const int gox = s.gridOrigin.x(), goy = s.gridOrigin.y();
+
+    // Background and MAZE, straight from the wall layer
+    const int layerW = qMax(0, qMin(imgW, walls.image.width() - ox));
+    for (int y = y0; y < y1; ++y) {
+        uchar *row = bits + y * bpl;
+        if (y + oy < walls.image.height() && layerW > 0) {
+            std::memcpy(row, walls.image.constScanLine(y + oy) + ox, layerW);
+            std::memset(row + layerW, SlotBackground, imgW - layerW);
+        } else {
+            std::memset(row, SlotBackground, imgW);
+        }
+    }
+
+    // Cells under the camera that touch this band
+    const int firstRow = (y0 + oy) / cs;
+    const int lastRow = qMin(s.rows - 1, (y1 - 1 + oy) / cs);
+    const int firstCol = ox / cs;
+    const int lastCol = qMin(s.cols - 1, (ox + imgW - 1) / cs);
+
+    // No layer for this board: only the walls in view
+    if (walls.image.isNull())
+        for (int gy = firstRow; gy <= lastRow; ++gy)
+            for (int gx = firstCol; gx <= lastCol; ++gx)
+                if (s.maze->test(gx - gox, gy - goy))
+                    blitTile(bits, bpl, imgW, tiles.wall, cs, gx * cs - ox, gy * cs - oy, y0, y1);
+
+    // FOOD dots
+    for (int gy = firstRow; gy <= lastRow; ++gy)
+        for (int gx = firstCol; gx <= lastCol; ++gx)
+            if (s.food->test(gx - gox, gy - goy))
+                blitTile(bits, bpl, imgW, tiles.food, cs, gx * cs - ox, gy * cs - oy, y0, y1);
+
+    // ENEMIES, culled in render()
+    const bool enemiesSlide = s.enemiesFrom && s.enemiesFrom->size() == s.enemies->size();
+    for (int slot = 0; slot < visibleEnemies.size(); ++slot) {
+        const int i = visibleEnemies[slot];
+        const Enemy &e = (*s.enemies)[i];
+        const QPoint to(e.x, e.y);
+        const QPoint px = slide(enemiesSlide ? (*s.enemiesFrom)[i] : to, to, s.t, cs);
+        fillRect(bits, bpl, imgW, px.x() - ox, px.y() - oy, cs, cs, y0, y1, uchar(SlotEnemy + slot));
+    }
+
+    // PAC-MAN (mouth wedge baked into the tile)
+    const QPoint px = slide(QPoint(s.playerFromX, s.playerFromY),
+                            QPoint(s.playerX, s.playerY), s.t, cs);
+    blitTile(bits, bpl, imgW, tiles.player[playerTileIndex(s)], cs,
+             px.x() - ox, px.y() - oy, y0, y1);
+}
@@ -0,0 +1,180 @@
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <QCache>
+#include <QImage>
+#include <QThreadPool>
+#include <QVector>
+
+#include "crtfilter.h"
+#include "gametypes.h"
+
+class AssetArchive;
+class LevelCache;
+
+// ==============================
+// 🖼 BANDED SOFTWARE RASTERIZER
+// ==============================
+
+// Everything the rasterizer needs to draw one frame. The pointers refer to
+// MainWindow's state and only have to stay valid for the render() call.
+struct RenderScene {
+    int rows = 0, cols = 0;
+    int cellSize = 0;
+
+    // Largest frame wanted; a board bigger than this scrolls to keep
+    // Pac-Man centred. Empty means the whole board.
+    QSize viewport;
+
+    // May cover only part of the board, from gridOrigin; cells outside
+    // are drawn empty. Such a part is never given a wall layer.
+    const BitGrid *maze = nullptr;
+    const BitGrid *food = nullptr;
+    QPoint gridOrigin;
+    const QVector<Enemy> *enemies = nullptr;
+    int playerX = 0, playerY = 0;
+    int playerDirX = 0, playerDirY = 0;
+    bool mouthOpen = false;
+
+    // Sub-cell motion: sprites are drawn t of the way from the *From
+    // cells to their current ones. enemiesFrom may be null.
+    const QVector<QPoint> *enemiesFrom = nullptr;
+    int playerFromX = 0, playerFromY = 0;
+    float t = 1.0f;
+};
+
+// Splits the frame into horizontal bands and rasterizes them in parallel.
+// Every band draws the full layer stack clipped to its own rows, so the
+// result is bit-identical to a single-threaded render regardless of the
+// thread count. The CRT pass runs as a second banded stage once the
+// raster bands are joined. render() returns only after both stages.
+//
+// The scene is rasterized into an 8-bit indexed framebuffer and only
+// expanded to RGB32 through the palette at present time. The indexed
+// buffer is kept between frames, so a palette change can be shown with
+// recolor() without rasterizing anything.
+//
+// Background and walls are drawn once per maze and cell size into a
+// layer that every frame starts from. prepareWalls() builds the layer of
+// an upcoming maze ahead of time, so a level switch costs a row copy.
+// Past kMaxWallLayerBytes, or for a maze that is only the streamed part
+// of a board, there is no layer and the visible walls are blitted cell by
+// cell instead.
+//
+// Only what is inside the camera is touched: rows and columns of cells
+// outside it are skipped, and enemies outside it take no palette slot,
+// so frame cost follows the window size, not the board size.
+//
+// Sprites are blitted from tiles rasterized once per cell size, so any
+// window size or device pixel ratio renders natively without scaling the
+// finished image. Sizes baked into the asset archive are used straight
+// from the mapped file.
+class FrameRenderer
+{
+public:
+    enum PaletteSlot : uchar {
+        SlotBackground = 0,
+        SlotWall,
+        SlotFood,
+        SlotPlayer,
+        SlotEnemy = 8   // one slot per enemy from here on
+    };
+
+    FrameRenderer();
+    ~FrameRenderer();
+
+    // 0 picks QThread::idealThreadCount(); 1 renders inline on the caller.
+    void setThreadCount(int count);
+    int threadCount() const { return threads; }
+
+    void setCrtEnabled(bool on) { crtEnabled = on; }
+    bool isCrtEnabled() const { return crtEnabled; }
+    CrtFilter &crtFilter() { return crt; }
+
+    // Enemy slots are refreshed from the scene on every render().
+    void setPaletteColor(int slot, const QColor &color);
+    QColor paletteColor(int slot) const;
+
+    // Renders into `into`, reusing its pixels when it already has the
+    // frame's size and nobody else holds them. False if nothing was drawn.
+    bool render(const RenderScene &scene, QImage &into);
+    QImage render(const RenderScene &scene);
+
+    // Re-expands the last rendered frame with the current palette.
+    bool recolor(QImage &into);
+    QImage recolor();
+
+    // Wall layer for a maze about to be played; kept until a frame uses
+    // it or the next call replaces it.
+    void prepareWalls(const BitGrid &maze, int cellSize);
+
+    // Number of distinct cell sizes whose tiles are kept around.
+    static constexpr int kTileCacheScales = 8;
+
+    // A 4096x4096 board is gigabytes of layer at any playable cell size
+    static constexpr qint64 kMaxWallLayerBytes = qint64(64) << 20;
+
+    // Pre-rasterized tiles; the archive must outlive the renderer.
+    void setAssets(const AssetArchive *archive);
+
+    // Wall layers of big mazes are kept on disk; must outlive the renderer.
+    void setLevelCache(LevelCache *c) { cache = c; }
+
+    // wall, food, then the five player tiles, cellSize^2 bytes each.
+    // This is also what tools/assetpack bakes into the archive.
+    static constexpr int kTileCount = 7;
+    static QByteArray rasterizeTiles(int cellSize);
+
+private:
+    struct Band { int y0, y1; };
+
+    // Pre-rasterized, opaque cellSize x cellSize tiles for one scale.
+    struct TileSet {
+        int cellSize = 0;
+        QByteArray storage;         // raw view when it comes from the archive
+        const uchar *wall = nullptr;
+        const uchar *food = nullptr;
+        const uchar *player[5] = {};   // closed, right, left, down, up
+    };
+
+    // Background and walls, same indexed layout as the frame
+    struct WallLayer {
+        BitGrid maze;
+        int cellSize = 0;
+        QImage image;
+        bool direct = false;        // too big; walls are drawn per frame
+
+        bool matches(const BitGrid &m, int cs) const;
+    };
+
+    const TileSet *tilesFor(int cellSize);
+    const WallLayer &wallsFor(const BitGrid &maze, int cellSize);
+    void buildWalls(WallLayer &layer, const BitGrid &maze, int cellSize);
+    static int playerTileIndex(const RenderScene &s);
+
+    template <typename Fn>
+    void forEachBand(int height, Fn &&fn);
+
+    void renderBand(const RenderScene &s, const TileSet &tiles, const WallLayer &walls,
+                    const QRect &view, uchar *bits, qsizetype bpl, int y0, int y1) const;
+    void expandBand(uchar *rgbBits, qsizetype rgbBpl, int y0, int y1) const;
+    void present(QImage &into);
+
+    QThreadPool pool;
+    int threads;
+
+    QVector<QRgb> palette;
+    QImage indexed;
+    QImage expanded;                // CRT input, never handed out
+    QVector<int> visibleEnemies;    // palette slot order
+    QCache<int, TileSet> tileCache;
+    WallLayer walls, nextWalls;
+    WallLayer noWalls;              // for a maze that is only part of the board
+    const AssetArchive *assets = nullptr;
+    LevelCache *cache = nullptr;
+
+    CrtFilter crt;
+    bool crtEnabled = true;
+};
+
+#endif // FRAMERENDERER_H
@@ -0,0 +1,143 @@
+#include "framescheduler.h"
+
+Q_LOGGING_CATEGORY(lcPerf, "pacman.perf", QtWarningMsg)
+
+// ----- TimingHistogram -----
+TimingHistogram::TimingHistogram(qint64 bucketNs, int bucketCount)
+    : bucketNs(qMax<qint64>(1, bucketNs)), buckets(qMax(1, bucketCount), 0)
+{
+}
+
+void TimingHistogram::record(qint64 ns)
+{
+    if (ns < 0) ns = 0;
+    const qint64 idx = ns / bucketNs;
+    if (idx < buckets.size())
+        buckets[idx]++;
+    else
+        overflow++;
+    total++;
+    maxNs = qMax(maxNs, ns);
+}
+
+void TimingHistogram::reset()
+{
+    buckets.fill(0);
+    overflow = 0;
+    total = 0;
+    maxNs = 0;
+}
+
+// Upper edge of the bucket holding the p-th sample (p in 0..1).
+qint64 TimingHistogram::percentile(double p) const
+{
+    if (total == 0) return 0;
+    const qint64 rank = qMax<qint64>(1, qint64(p * total + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return qMin(maxNs, (i + 1) * bucketNs);
+    }
+    return maxNs;
+}
+
+QString TimingHistogram::summary() const
+{
+    return QString("p50 %1 ms, p99 %2 ms, max %3 ms (n=%4)")
+        .arg(percentile(0.50) / 1e6, 0, 'f', 2)
+        .arg(percentile(0.99) / 1e6, 0, 'f', 2)
+        .arg(maxNs / 1e6, 0, 'f', 2)
+        .arg(total);
+}
+
+// ----- FrameScheduler -----
+FrameScheduler::FrameScheduler(QObject *parent)
+    : QObject(parent)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &FrameScheduler::onTick);
+    clock.start();
+}
+
+void FrameScheduler::setRefreshRate(qreal rate)
+{
+    if (rate < 1.0) rate = 60.0;
+    hz = rate;
+    periodNs = qint64(1e9 / hz);
+}
+
+void FrameScheduler::start()
+{
+    if (active) return;
+    active = true;
+    lastTickNs = -1;
+    nextDeadlineNs = clock.nsecsElapsed();
+    scheduleNext();
+}
+
+void FrameScheduler::stop()
+{
+    active = false;
+    timer.stop();
+}
+
+void FrameScheduler::requestFrame()
+{
+    dirty = true;
+    if (!active)
+        onTick();
+}
+
+void FrameScheduler::resetStats()
+{
+    intervals.reset();
+    renders.reset();
+    janks = 0;
+}
+
+void FrameScheduler::onTick()
+{
+    const qint64 now = clock.nsecsElapsed();
+
+    if (active) {
+        if (lastTickNs >= 0) {
+            const qint64 interval = now - lastTickNs;
+            intervals.record(interval);
+            // More than half a period late means a missed refresh
+            if (interval > periodNs + periodNs / 2) {
+                janks++;
+                emit jank(interval, periodNs);
+            }
+        }
+        lastTickNs = now;
+    }
+
+    if (dirty) {
+        dirty = false;
+        emit frameDue();
+        const qint64 cost = clock.nsecsElapsed() - now;
+        if (active) {
+            renders.record(cost);
+            if (cost > periodNs) {
+                janks++;
+                emit jank(cost, periodNs);
+            }
+        }
+    }
+
+    if (active)
+        scheduleNext();
+}
+
+// Deadlines advance by exactly one period so the average rate does not
+// drift with millisecond timer granularity; missed slots are skipped.
+void FrameScheduler::scheduleNext()
+{
+    const qint64 now = clock.nsecsElapsed();
+    nextDeadlineNs += periodNs;
+    if (nextDeadlineNs <= now)
+        nextDeadlineNs = now + periodNs;
+    timer.start(int((nextDeadlineNs - now) / 1000000));
+}
@@ -0,0 +1,183 @@
+#include "gamehud.h"
+#include "pixelfont.h"
+#include <QImage>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+namespace {
+
+constexpr int kGlyphScale = 2;     // 8x8 glyphs drawn at 16x16 logical px
+constexpr int kGlyphPx = PixelFont::kGlyphSize * kGlyphScale;
+constexpr int kOuterMarginX = 20;
+constexpr int kOuterMarginY = 10;
+constexpr int kPanelSpacing = 30;
+constexpr int kPanelPadX = 16;
+constexpr int kPanelPadY = 10;
+constexpr int kBorderBottom = 4;
+
+const QChar kHeart(0x2665);
+const QChar kSkull(0x2620);
+
+} // namespace
+
+GameHUD::GameHUD(QWidget *parent) : QWidget(parent)
+{
+    // We paint every pixel ourselves, nothing to erase or style
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    panels[ScorePanel].maxChars = 13;   // "SCORE: 000000"
+    panels[ScorePanel].color = QColor("yellow");
+    panels[LivesPanel].maxChars = 12;   // "LIVES: ♥ ♥ ♥"
+    panels[LivesPanel].color = QColor("red");
+    panels[LevelPanel].maxChars = 9;    // "LEVEL: 10"
+    panels[LevelPanel].color = QColor("dodgerblue");
+
+    setFixedHeight(sizeHint().height());
+    layoutPanels();
+
+    setScore(0);
+    setLives(3);
+    setLevel(1);
+}
+
+QSize GameHUD::sizeHint() const
+{
+    int w = 2 * kOuterMarginX;
+    for (int i = 0; i < PanelCount; ++i)
+        w += panels[i].maxChars * kGlyphPx + 2 * kPanelPadX + (i ? kPanelSpacing : 0);
+    const int h = 2 * kOuterMarginY + kGlyphPx + 2 * kPanelPadY + kBorderBottom;
+    return QSize(w, h);
+}
+
+QSize GameHUD::minimumSizeHint() const
+{
+    return QSize(0, sizeHint().height());
+}
+
+void GameHUD::layoutPanels()
+{
+    int x = kOuterMarginX;
+    for (Panel &p : panels) {
+        const int w = p.maxChars * kGlyphPx + 2 * kPanelPadX;
+        p.rect = QRect(x, kOuterMarginY, w, kGlyphPx + 2 * kPanelPadY);
+        x += w + kPanelSpacing;
+    }
+}
+
+QRect GameHUD::charRect(int panel, int index) const
+{
+    const QRect &r = panels[panel].rect;
+    return QRect(r.x() + kPanelPadX + index * kGlyphPx, r.y() + kPanelPadY,
+                 kGlyphPx, kGlyphPx);
+}
+
+// Update values dynamically
+void GameHUD::setScore(int value)
+{
+    setPanelText(ScorePanel, QString("SCORE: %1").arg(value, 4, 10, QLatin1Char('0')));
+}
+
+void GameHUD::setLives(int value)
+{
+    QString hearts;
+    for (int i = 0; i < value; ++i) {
+        if (i) hearts += QLatin1Char(' ');
+        hearts += kHeart;
+    }
+    if (value <= 0) hearts = kSkull;
+
+    setPanelText(LivesPanel, QString("LIVES: %1").arg(hearts));
+}
+
+void GameHUD::setLevel(int value)
+{
+    setPanelText(LevelPanel, QString("LEVEL: %1").arg(value));
+}
+
+void GameHUD::setPanelText(int panel, const QString &text)
+{
+    Panel &p = panels[panel];
+    const int n = qMin(p.maxChars, qMax(p.text.size(), text.size()));
+    for (int i = 0; i < n; ++i) {
+        const QChar before = i < p.text.size() ? p.text.at(i) : QChar(' ');
+        const QChar after = i < text.size() ? text.at(i) : QChar(' ');
+        if (before != after)
+            update(charRect(panel, i));
+    }
+    p.text = text;
+}
+
+void GameHUD::resizeEvent(QResizeEvent *e)
+{
+    QWidget::resizeEvent(e);
+    background = QPixmap();   // rebuilt lazily at the new size
+}
+
+void GameHUD::rebuildCaches()
+{
+    const qreal dpr = devicePixelRatio();
+
+    // ---- background: bar, bottom border and empty panels ----
+    background = QPixmap(size() * dpr);
+    background.setDevicePixelRatio(dpr);
+    {
+        QPainter p(&background);
+        p.fillRect(rect(), QColor("#2E2E2E"));
+        p.fillRect(QRect(0, height() - kBorderBottom, width(), kBorderBottom), QColor("#555555"));
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setPen(QPen(QColor("#5A5A5A"), 2));
+        p.setBrush(QColor("#3A3A3A"));
+        for (const Panel &panel : panels)
+            p.drawRoundedRect(QRectF(panel.rect).adjusted(1, 1, -1, -1), 6, 6);
+    }
+
+    // ---- glyph atlas, nearest-neighbour scaled to device pixels ----
+    const int dev = qRound(kGlyphPx * dpr);
+    if (dev == glyphPx && !atlas.isNull())
+        return;
+    glyphPx = dev;
+
+    const int count = PixelFont::glyphCount();
+    QImage img(count * dev, PanelCount * dev, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    for (int row = 0; row < PanelCount; ++row) {
+        const QRgb color = panels[row].color.rgb();
+        for (int g = 0; g < count; ++g) {
+            const PixelGlyph &glyph = PixelFont::glyphs()[g];
+            for (int y = 0; y < dev; ++y) {
+                const unsigned char bits = glyph.rows[y * PixelFont::kGlyphSize / dev];
+                QRgb *line = reinterpret_cast<QRgb *>(img.scanLine(row * dev + y)) + g * dev;
+                for (int x = 0; x < dev; ++x)
+                    if (bits & (0x80 >> (x * PixelFont::kGlyphSize / dev)))
+                        line[x] = color;
+            }
+        }
+    }
+    atlas = QPixmap::fromImage(img);
+}
+
+void GameHUD::paintEvent(QPaintEvent *e)
+{
+    const qreal dpr = devicePixelRatio();
+    if (background.isNull() || background.devicePixelRatio() != dpr)
+        rebuildCaches();
+
+    QPainter p(this);
+    const QRect dirty = e->rect();
+    p.drawPixmap(QRectF(dirty), background,
+                 QRectF(dirty.x() * dpr, dirty.y() * dpr, dirty.width() * dpr, dirty.height() * dpr));
+
+    for (int panel = 0; panel < PanelCount; ++panel) {
+        const Panel &pn = panels[panel];
+        if (!pn.rect.intersects(dirty)) continue;
+        const int n = qMin(pn.text.size(), pn.maxChars);
+        for (int i = 0; i < n; ++i) {
+            const QRect r = charRect(panel, i);
+            if (!r.intersects(dirty)) continue;
+            const int g = PixelFont::indexOf(pn.text.at(i));
+            if (g < 0) continue;
+            p.drawPixmap(QRectF(r), atlas, QRectF(g * glyphPx, panel * glyphPx, glyphPx, glyphPx));
+        }
+    }
+}
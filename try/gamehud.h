@@ -0,0 +1,57 @@
+#ifndef GAMEHUD_H
+#define GAMEHUD_H
+
+#include <QColor>
+#include <QPixmap>
+#include <QRect>
+#include <QString>
+#include <QWidget>
+
+// ==============================
+// 🎮 SELF-PAINTED HUD
+// ==============================
+
+// Score/lives/level bar painted straight from a pre-rasterized glyph
+// atlas. Setters compare the new text with what is on screen and only
+// invalidate the character cells that changed, so eating a pellet
+// repaints a digit or two instead of relaying out styled labels.
+class GameHUD : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit GameHUD(QWidget *parent = nullptr);
+
+    void setScore(int value);
+    void setLives(int value);
+    void setLevel(int value);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *e) override;
+    void resizeEvent(QResizeEvent *e) override;
+
+private:
+    enum PanelId { ScorePanel, LivesPanel, LevelPanel, PanelCount };
+
+    struct Panel {
+        QString text;
+        int maxChars = 0;
+        QColor color;
+        QRect rect;
+    };
+
+    void setPanelText(int panel, const QString &text);
+    QRect charRect(int panel, int index) const;
+    void layoutPanels();
+    void rebuildCaches();
+
+    Panel panels[PanelCount];
+
+    QPixmap atlas;       // one row of glyphs per panel colour
+    QPixmap background;  // bar and empty panels at widget size
+    int glyphPx = 0;     // glyph cell size in device pixels
+};
+
+#endif // GAMEHUD_H
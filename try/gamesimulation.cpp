@@ -0,0 +1,633 @@
+#include "gamesimulation.h"
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+namespace {
+
+// One bit per arrow for the held-key mask
+inline quint8 dirBit(int dx, int dy)
+{
+    return dx < 0 ? 1 : dx > 0 ? 2 : dy < 0 ? 4 : dy > 0 ? 8 : 0;
+}
+
+} // namespace
+
+GameSimulation::GameSimulation(LevelLibrary &library, QObject *parent)
+    : QObject(parent), library(library)
+{
+    timer = new QTimer(this);
+    timer->setTimerType(Qt::PreciseTimer);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &GameSimulation::advance);
+
+    worldBuild = new QFutureWatcher<QString>(this);
+    connect(worldBuild, &QFutureWatcher<QString>::finished, this, &GameSimulation::worldBuilt);
+
+    // Level 1 sits behind the menu until a level is picked
+    initMaze(currentLevel);
+    initFood();
+    initEnemies();
+    holdPositions();
+    tickNs = monotonicNs();
+    publish(GameSnapshot::Idle);
+}
+
+GameSimulation::~GameSimulation()
+{
+    // The job emits through us
+    preload.waitForFinished();
+    worldBuild->waitForFinished();
+}
+
+void GameSimulation::startLevel(int level)
+{
+    awaitingWorld = false;
+    megaSide = 0;
+    currentLevel = level;
+    beginLevel();
+    if (currentLevel < levelCount())
+        preloadLevel(currentLevel + 1);
+}
+
+// A single board; there is no next level to preload. Generating,
+// compressing and writing a big one takes seconds, so unless it is still
+// open from the last run that happens off this thread, and the ticks wait
+// for it instead of stalling.
+void GameSimulation::startMegaMaze(int side)
+{
+    megaSide = side;
+    currentLevel = 1;
+    running = false;
+    timer->stop();
+    if (loadedKey == -side) {
+        awaitingWorld = false;
+        beginLevel();
+        return;
+    }
+    awaitingWorld = true;
+    LevelLibrary &lib = library;
+    worldBuild->setFuture(QtConcurrent::run([&lib, side]() { return lib.megaWorld(side); }));
+}
+
+void GameSimulation::worldBuilt()
+{
+    if (!awaitingWorld)
+        return;
+    awaitingWorld = false;
+    megaPath = worldBuild->result();
+    beginLevel();
+}
+
+void GameSimulation::beginLevel()
+{
+    if (!initMaze(currentLevel)) {
+        running = false;
+        emit levelFailed(QString("The %1x%1 mega maze could not be built.").arg(megaSide));
+        return;
+    }
+    initFood();
+    initEnemies();
+    streamWorld();
+    lives = 3;
+    playerDirX = playerDirY = 0;
+    mouthOpen = false;
+
+    // Keys pressed while the menu was up belong to the menu
+    InputEvent stale;
+    while (input.pop(stale)) {}
+    pendingInput.clear();
+    heldKeys = 0;
+    tapPending = false;
+    turn = BufferedTurn();
+    {
+        QMutexLocker locker(&statsLock);
+        inputLatency.reset();
+        tickTimes = TickStats();
+    }
+
+    if (mixer) mixer->setMusicPlaying(true);
+    emit statsChanged(score, lives, currentLevel);
+
+    // First tick one period from now, as the old interval timer did
+    holdPositions();
+    tickNs = monotonicNs();
+    publish(GameSnapshot::Running);
+    running = true;
+    nextTickNs = tickNs + periodNs;
+    scheduleWake();
+    emit levelStarted();
+}
+
+void GameSimulation::stop()
+{
+    awaitingWorld = false;
+    running = false;
+    timer->stop();
+}
+
+void GameSimulation::setTickRate(double hz)
+{
+    periodNs = qint64(1e9 / qBound(kMinTickHz, hz, kMaxTickHz));
+}
+
+void GameSimulation::setWorldMemoryCap(qint64 bytes)
+{
+    world.setMemoryCap(bytes);
+}
+
+// ======== CLOCK ========
+
+// Runs every tick that is due, oldest first. Each tick is stamped with
+// its own deadline, not the wall clock, so catching up is indistinguishable
+// from having been on time.
+void GameSimulation::advance()
+{
+    int steps = 0;
+    qint64 now = monotonicNs();
+    while (running && nextTickNs <= now && steps < kMaxCatchUpTicks) {
+        const qint64 start = monotonicNs();
+        tick(nextTickNs);
+        const qint64 end = monotonicNs();
+        {
+            QMutexLocker locker(&statsLock);
+            tickTimes.duration.record(end - start);
+            tickTimes.lateness.record(start - nextTickNs);
+            tickTimes.ai.record(aiNs);
+            ++tickTimes.ticks;
+            tickTimes.world = world.stats();
+        }
+        nextTickNs += periodNs;
+        ++steps;
+        now = end;
+    }
+    if (!running) return;
+
+    // Too far behind to catch up (debugger, suspend): skip the backlog so
+    // the game slows down instead of fast-forwarding
+    if (nextTickNs <= now) {
+        const qint64 behind = (now - nextTickNs) / periodNs + 1;
+        nextTickNs += behind * periodNs;
+        QMutexLocker locker(&statsLock);
+        tickTimes.dropped += behind;
+    }
+    scheduleWake();
+}
+
+// QTimer only has millisecond resolution, so round up and let the loop
+// above pick up whatever is due when it fires
+void GameSimulation::scheduleWake()
+{
+    const qint64 waitNs = qMax<qint64>(0, nextTickNs - monotonicNs());
+    timer->start(int((waitNs + 999999) / 1000000));
+}
+
+// ======== LEVELS ========
+
+void GameSimulation::preloadLevel(int levelNumber)
+{
+    if (preloadNumber == levelNumber || loadedKey == levelNumber)
+        return;
+    preload.waitForFinished();
+    preloadNumber = levelNumber;
+    preload = QtConcurrent::run([this, levelNumber]() {
+        LevelTemplate t = library.level(levelNumber);
+        emit levelPreloaded(levelNumber, t->walls);
+        return t;
+    });
+}
+
+bool GameSimulation::initMaze(int levelNumber)
+{
+    if (levelNumber <= 0 || levelNumber > levelCount())
+        levelNumber = 1;
+
+    // Retrying keeps what is loaded; the next level is usually ready
+    const int key = megaSide > 0 ? -megaSide : levelNumber;
+    if (key != loadedKey) {
+        world.close();
+        if (megaSide > 0) {
+            // Only ever streamed; a whole board this size is hundreds of MB
+            // of tables and a 2 MB copy of the pellets per pellet eaten
+            if (!world.open(megaPath)) {
+                loadedKey = 0;
+                return false;
+            }
+            level = LevelTemplate(new LevelData(world.head()));
+        } else if (preloadNumber == levelNumber) {
+            level = preload.result();
+            preload = QFuture<LevelTemplate>();
+            preloadNumber = 0;
+        } else {
+            level = library.level(levelNumber);
+        }
+        loadedKey = key;
+        router.setLevel(*level);
+    }
+
+    maze = level->walls;
+    rows = world.isOpen() ? world.rows() : maze.rows();
+    cols = world.isOpen() ? world.cols() : maze.cols();
+    playerX = level->playerStart.x();
+    playerY = level->playerStart.y();
+    return true;
+}
+
+// Shared with the template until the first pellet is eaten
+void GameSimulation::initFood()
+{
+    if (world.isOpen()) {
+        world.reset();
+        food = BitGrid();
+        foodLeft = world.foodLeft();
+        return;
+    }
+    food = level->food;
+    foodLeft = food.count();
+}
+
+void GameSimulation::initEnemies()
+{
+    enemies = level->enemies;
+}
+
+// Keeps the chunks around Pac-Man loaded, a ring past what is published.
+// Only that area is wanted, so the memory cap holds however many enemies
+// the board has; the ones outside it wait (see moveEnemies()). Never waits
+// for a load.
+void GameSimulation::streamWorld()
+{
+    if (!world.isOpen())
+        return;
+    wanted.clear();
+    wanted.append(streamedArea());
+    world.update(wanted);
+}
+
+QRect GameSimulation::streamedArea() const
+{
+    const int reach = (kStreamRadius + 1) * ChunkedWorld::kChunkSide;
+    return QRect(playerX - reach, playerY - reach, 2 * reach + 1, 2 * reach + 1);
+}
+
+// --- A* helpers ---
+bool GameSimulation::isWalkable(int x, int y) const {
+    return world.isOpen() ? !world.isWall(x, y) : !maze.isWall(x, y);
+}
+
+// Compute next step towards (tx,ty) from (sx,sy) using A* with 4-neighbour moves.
+// Cells outside bounds, when given, are not searched. Scratch covers just
+// the searched rect and is kept between calls, reset by stamping.
+bool GameSimulation::aStarNextStep(int sx, int sy, int tx, int ty, int &nx, int &ny,
+                                   const QRect &bounds) {
+    if (sx == tx && sy == ty) return false;
+
+    const QRect board(0, 0, cols, rows);
+    const QRect area = bounds.isNull() ? board : bounds & board;
+    if (!area.contains(sx, sy) || !area.contains(tx, ty)) return false;
+
+    const int areaW = area.width();
+    const int cells = areaW * area.height();
+    if (stepScratch.size() < cells) stepScratch.resize(cells);
+    if (++stepEpoch == 0) {
+        stepScratch.fill(StepScratch());
+        stepEpoch = 1;
+    }
+    stepHeap.clear();
+
+    // Manhattan, tightened by the level's landmark distances where known
+    const LandmarkTable &marks = level->landmarks;
+    const int goalCell = ty * cols + tx;
+    auto heuristic = [&](int x, int y) {
+        const int manhattan = std::abs(x - tx) + std::abs(y - ty);
+        if (!marks.count) return manhattan;
+        return qMax(manhattan, marks.lowerBound(y * cols + x, goalCell));
+    };
+
+    auto slot = [&](int x, int y) -> StepScratch & {
+        return stepScratch[(y - area.top()) * areaW + (x - area.left())];
+    };
+
+    slot(sx, sy) = StepScratch{ stepEpoch, 0, 0, 0, false };
+    stepHeap.push_back(StepEntry{ heuristic(sx, sy), 0, sx, sy });
+
+    static const qint8 dirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    while (!stepHeap.empty()) {
+        std::pop_heap(stepHeap.begin(), stepHeap.end());
+        const StepEntry cur = stepHeap.back();
+        stepHeap.pop_back();
+
+        StepScratch &c = slot(cur.x, cur.y);
+        if (c.closed) continue;
+        c.closed = true;
+
+        if (cur.x == tx && cur.y == ty) {
+            nx = sx + c.dx;
+            ny = sy + c.dy;
+            return true;
+        }
+
+        const bool atStart = cur.g == 0;
+        for (const auto &d : dirs) {
+            const int x = cur.x + d[0], y = cur.y + d[1];
+            if (!area.contains(x, y) || !isWalkable(x, y)) continue;
+            StepScratch &n = slot(x, y);
+            const int g = cur.g + 1;
+            if (n.stamp == stepEpoch && (n.closed || n.g <= g)) continue;
+            n = StepScratch{ stepEpoch, g, atStart ? d[0] : c.dx, atStart ? d[1] : c.dy, false };
+            stepHeap.push_back(StepEntry{ g + heuristic(x, y), g, x, y });
+            std::push_heap(stepHeap.begin(), stepHeap.end());
+        }
+    }
+
+    return false;
+}
+
+// Junctions are the only places with a choice. In a corridor a chasing
+// enemy keeps going unless Pac-Man is on that same corridor.
+bool GameSimulation::chaseStep(const Enemy &e, int &dx, int &dy)
+{
+    const QPoint at(e.x, e.y), target(playerX, playerY);
+    if (router.isValid()) {
+        if (e.chasing && router.inCorridor(e.x, e.y) && !router.sameCorridor(at, target)
+            && router.corridorAhead(at, QPoint(e.x - e.dx, e.y - e.dy), dx, dy))
+            return true;
+        if (router.firstStep(at, target, dx, dy))
+            return true;
+    }
+
+    // Off the graph, e.g. spawned outside the reachable part of the maze.
+    // A streamed board has no graph; its searches stay in the part of the
+    // habitat that is streamed in.
+    QRect bounds;
+    if (world.isOpen()) {
+        bounds = e.habitat & streamedArea();
+        if (bounds.isEmpty())
+            return false;
+    }
+    int nx = e.x, ny = e.y;
+    if (!aStarNextStep(e.x, e.y, playerX, playerY, nx, ny, bounds))
+        return false;
+    dx = nx - e.x;
+    dy = ny - e.y;
+    return true;
+}
+
+// On a streamed board only the enemies in the streamed area move; the
+// rest hold still, well off screen, until Pac-Man comes near.
+void GameSimulation::moveEnemies()
+{
+    QPoint playerPt(playerX, playerY);
+    const QRect active = world.isOpen() ? streamedArea() : QRect();
+
+    for (auto &e : enemies) {
+        if (!active.isNull() && !active.contains(e.x, e.y))
+            continue;
+        if (e.cooldown > 0) {
+            e.cooldown--;
+            continue;
+        }
+        e.cooldown = e.moveInterval;
+
+        if (e.type == EnemyType::Smart) {
+            bool playerInHabitat = e.habitat.contains(playerPt);
+            int dx = 0, dy = 0;
+            if (playerInHabitat && chaseStep(e, dx, dy)) {
+                e.dx = dx;
+                e.dy = dy;
+                e.x += dx;
+                e.y += dy;
+                e.chasing = true;
+                continue;
+            }
+            e.chasing = false;
+            int tryx = e.x + e.dx;
+            int tryy = e.y + e.dy;
+            if (isWalkable(tryx, tryy)) {
+                e.x = tryx; e.y = tryy;
+            } else {
+                if (e.dx != 0) e.dx = -e.dx;
+                else if (e.dy != 0) e.dy = -e.dy;
+            }
+        } else {
+            int tryx = e.x + e.dx;
+            int tryy = e.y + e.dy;
+            if (isWalkable(tryx, tryy)) {
+                e.x = tryx; e.y = tryy;
+            } else {
+                if (e.dx != 0) e.dx = -e.dx;
+                if (e.dy != 0) e.dy = -e.dy;
+            }
+        }
+    }
+}
+
+void GameSimulation::eatAt(int x, int y)
+{
+    if (world.isOpen()) {
+        if (!world.eat(x, y))
+            return;
+    } else {
+        if (!food.test(x, y))
+            return;
+        food.set(x, y, false);
+    }
+    --foodLeft;
+    score += 10;
+    emit statsChanged(score, lives, currentLevel);
+    playSfx(AudioMixer::Eat, 0.65f);    // 🔊 PLAY EAT SOUND
+}
+
+void GameSimulation::checkCollisions()
+{
+    eatAt(playerX, playerY);
+
+    for (auto &e : enemies)
+        if (e.x == playerX && e.y == playerY) {
+            // Reset on collision
+            playerX = level->playerStart.x();
+            playerY = level->playerStart.y();
+            initEnemies();
+
+            lives -= 1;
+            emit statsChanged(score, lives, currentLevel);
+
+            if (lives <= 0) {
+                running = false;
+                if (mixer) {
+                    mixer->setMusicPlaying(false);    // ⛔ Stop background music
+                    mixer->play(AudioMixer::Death, 0.9f);   // 🔊 Play death sound
+                }
+            }
+            break;
+        }
+}
+
+TimingHistogram GameSimulation::inputLatencyStats() const
+{
+    QMutexLocker locker(&statsLock);
+    return inputLatency;
+}
+
+GameSimulation::TickStats GameSimulation::tickStats() const
+{
+    QMutexLocker locker(&statsLock);
+    return tickTimes;
+}
+
+// Key changes up to this tick's deadline, replayed in the order they
+// happened. Anything stamped later waits for the tick it belongs to.
+void GameSimulation::drainInput(qint64 untilNs)
+{
+    InputEvent e;
+    while (input.pop(e))
+        pendingInput.append(e);
+
+    int used = 0;
+    while (used < pendingInput.size() && pendingInput[used].timeNs <= untilNs)
+        applyInput(pendingInput[used++]);
+    pendingInput.remove(0, used);
+}
+
+void GameSimulation::applyInput(const InputEvent &e)
+{
+    const quint8 bit = dirBit(e.dx, e.dy);
+    if (e.kind == InputEvent::Press) {
+        heldKeys |= bit;
+        tapPending = true;      // survives a release before the tick
+        turn.dx = e.dx;
+        turn.dy = e.dy;
+        turn.pressNs = e.timeNs;
+        turn.valid = true;
+    } else {
+        heldKeys &= ~bit;
+        if (turn.valid && dirBit(turn.dx, turn.dy) == bit)
+            turn.releasedTick = tickCount;
+    }
+}
+
+void GameSimulation::movePlayer()
+{
+    const bool active = heldKeys != 0 || tapPending;
+    tapPending = false;
+
+    // Released arrows stop Pac-Man, as before; a short-lived turn stays armed
+    if (turn.valid && !(heldKeys & dirBit(turn.dx, turn.dy))
+        && tickCount - turn.releasedTick >= quint64(kTurnBufferTicks))
+        turn.valid = false;
+    if (!active) {
+        playerDirX = 0;
+        playerDirY = 0;
+        return;
+    }
+
+    // Take the buffered turn at the first open cell, otherwise keep going
+    if (turn.valid && isWalkable(playerX + turn.dx, playerY + turn.dy)) {
+        playerDirX = turn.dx;
+        playerDirY = turn.dy;
+        turn.valid = false;
+        QMutexLocker locker(&statsLock);
+        inputLatency.record(monotonicNs() - turn.pressNs);
+    } else if (turn.valid && playerDirX == 0 && playerDirY == 0) {
+        // standing still against a wall: at least face the way asked
+        playerDirX = turn.dx;
+        playerDirY = turn.dy;
+    }
+
+    int nx = playerX + playerDirX;
+    int ny = playerY + playerDirY;
+    if ((playerDirX || playerDirY) && isWalkable(nx, ny)) {
+        playerX = nx;
+        playerY = ny;
+
+        // Eat food immediately and update score/HUD
+        eatAt(playerX, playerY);
+    }
+}
+
+// Nothing moved since the last tick; the renderer draws sprites in place
+void GameSimulation::holdPositions()
+{
+    playerFrom = QPoint(playerX, playerY);
+    enemiesFrom.resize(enemies.size());
+    for (int i = 0; i < enemies.size(); ++i)
+        enemiesFrom[i] = QPoint(enemies[i].x, enemies[i].y);
+}
+
+void GameSimulation::tick(qint64 deadlineNs)
+{
+    ++tickCount;
+    tickNs = deadlineNs;
+    holdPositions();
+    streamWorld();
+    drainInput(deadlineNs);
+    mouthOpen = !mouthOpen;
+    movePlayer();
+
+    // Move enemies and check collisions every tick regardless of player movement
+    const qint64 aiStart = monotonicNs();
+    moveEnemies();
+    aiNs = monotonicNs() - aiStart;
+    checkCollisions();
+
+    if (lives <= 0) {
+        publish(GameSnapshot::Lost);
+        emit gameOver();
+        return;
+    }
+
+    if (foodLeft == 0) {
+        running = false;
+        if (mixer) {
+            mixer->setMusicPlaying(false);
+            mixer->play(AudioMixer::Win, 0.9f); // win sound
+        }
+        publish(GameSnapshot::Won);
+        emit levelCleared();
+        return;
+    }
+
+    publish(GameSnapshot::Running);
+}
+
+// Pan effects by the player's column so they follow Pac-Man across the board
+void GameSimulation::playSfx(AudioMixer::Sound id, float volume)
+{
+    if (!mixer) return;
+    const float pan = cols > 1 ? 2.0f * playerX / (cols - 1) - 1.0f : 0.0f;
+    mixer->play(id, volume, pan);
+}
+
+void GameSimulation::publish(GameSnapshot::State state)
+{
+    GameSnapshot &s = published.writeSlot();
+    s.tick = tickCount;
+    s.tickNs = tickNs;
+    s.periodNs = periodNs;
+    s.state = state;
+    s.rows = rows;
+    s.cols = cols;
+    if (world.isOpen()) {
+        const int r = kStreamRadius * ChunkedWorld::kChunkSide;
+        s.gridOrigin = world.copyRegion(QRect(playerX - r, playerY - r, 2 * r + 1, 2 * r + 1),
+                                        &s.maze, &s.food);
+    } else {
+        s.maze = maze;
+        s.food = food;
+        s.gridOrigin = QPoint();
+    }
+    s.enemies = enemies;
+    s.enemiesFrom = enemiesFrom;
+    s.playerX = playerX;
+    s.playerY = playerY;
+    s.playerFromX = playerFrom.x();
+    s.playerFromY = playerFrom.y();
+    s.playerDirX = playerDirX;
+    s.playerDirY = playerDirY;
+    s.mouthOpen = mouthOpen;
+    s.score = score;
+    s.lives = lives;
+    s.level = currentLevel;
+    published.publish();
+    emit snapshotPublished();
+}
@@ -0,0 +1,259 @@
+#ifndef GAMESIMULATION_H
+#define GAMESIMULATION_H
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QObject>
+#include <QPoint>
+#include <QTimer>
+#include <QVector>
+#include <vector>
+
+#include "audiomixer.h"
+#include "chunkedworld.h"
+#include "framescheduler.h"
+#include "gametypes.h"
+#include "levellibrary.h"
+#include "mazerouter.h"
+#include "spscring.h"
+#include "triplebuffer.h"
+
+// ==============================
+// 🧮 GAME SIMULATION
+// ==============================
+
+// The game rules, ticking at a fixed rate on their own thread. Nothing
+// here touches a widget: key changes arrive through a lock-free SPSC
+// queue that is drained at the start of every tick, and the state after
+// each tick is published through a triple buffer for the render thread.
+//
+// Key events carry their own timestamps and are replayed in order, so a
+// tap shorter than a tick still moves Pac-Man one cell. A turn pressed
+// before the junction is buffered and taken at the first walkable cell;
+// it stays armed while the key is held, or kTurnBufferTicks after release.
+//
+// Ticks come from a fixed-timestep accumulator on the monotonic clock,
+// not a repeating QTimer: each wake-up runs every tick whose deadline has
+// passed (at most kMaxCatchUpTicks, the rest is dropped rather than
+// spiralling) and then sleeps until the next deadline. Input is applied
+// by timestamp at the tick it belongs to, so a late or bursty wake-up
+// plays out exactly like an on-time one.
+//
+// Levels come from a LevelLibrary as shared, read-only templates; a
+// session owns only what play changes: the pellets left (a copy-on-write
+// bitset that shares the template's until the first bite), the enemies
+// and the router's scratch. Many sessions can run in one process on the
+// same few templates. The next level is fetched on the global thread
+// pool while the current one is played, so moving on only swaps it in.
+//
+// Smart enemies path over the level's junction graph through MazeRouter
+// and only decide at junctions; between them they follow the corridor.
+// Cell-by-cell A* is left for levels without a graph.
+//
+// startMegaMaze() plays one generated board of up to 4096x4096 instead
+// of the level list; clearing or losing it ends the run there. That board
+// is streamed: only the chunks around Pac-Man are in memory (see
+// ChunkedWorld) and only the enemies among them move. Snapshots carry
+// just the part of it around Pac-Man. There is no whole-board fallback:
+// if the world file can't be had, levelFailed() is emitted instead.
+//
+// Slots are meant to be invoked queued from the GUI thread; the signals
+// are emitted on the simulation thread.
+class GameSimulation : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr double kDefaultTickHz = 1000.0 / 120.0;
+    static constexpr double kMinTickHz = 8.0;
+    static constexpr double kMaxTickHz = 1000.0;    // bots
+    static constexpr int kMaxCatchUpTicks = 5;
+    static constexpr int kTurnBufferTicks = 3;
+
+    // Chunks around Pac-Man published on a streamed board; one more ring
+    // is kept loaded so they are in before they scroll into view
+    static constexpr int kStreamRadius = 3;
+
+    // Chunks across the loaded area at most, so kStreamChunks^2 of them
+    // must fit under the world's memory cap
+    static constexpr int kStreamChunks = 2 * (kStreamRadius + 1) + 2;
+    static_assert(qint64(kStreamChunks) * kStreamChunks * ChunkedWorld::kChunkBytes
+                      < ChunkedWorld::kDefaultMemoryCap, "streamed area over the default cap");
+
+    struct TickStats {
+        TimingHistogram duration;   // time spent inside one tick
+        TimingHistogram lateness;   // tick start past its deadline
+        TimingHistogram ai{1000};   // moveEnemies() per tick
+        qint64 ticks = 0;
+        qint64 dropped = 0;         // backlog beyond the catch-up limit
+        ChunkedWorld::Stats world;  // streamed board, after the last tick
+    };
+
+    // The library must outlive the simulation
+    explicit GameSimulation(LevelLibrary &library = LevelLibrary::global(),
+                            QObject *parent = nullptr);
+    ~GameSimulation() override;
+
+    // From the library, safe from any thread
+    int levelCount() const { return library.levelCount(); }
+
+    // Effects are played straight from the simulation thread
+    void setMixer(AudioMixer *m) { mixer = m; }
+
+    // Producer side of the input queue; the GUI thread only.
+    bool postInput(const InputEvent &e) { return input.push(e); }
+
+    // Consumer side is the render thread.
+    TripleBuffer<GameSnapshot> &snapshots() { return published; }
+
+    // Key press to the first tick that moved the player that way
+    TimingHistogram inputLatencyStats() const;
+
+    TickStats tickStats() const;
+
+public slots:
+    // Clamped to kMinTickHz..kMaxTickHz; takes effect from the next tick
+    void setTickRate(double hz);
+
+    // Memory for a streamed board's chunks, ChunkedWorld::kDefaultMemoryCap
+    // unless set
+    void setWorldMemoryCap(qint64 bytes);
+
+    void startLevel(int level);
+
+    // Generated side x side board; see LevelLibrary::megaWorld(). Its
+    // world file is made on the global pool the first time, and the
+    // level starts once it is ready.
+    void startMegaMaze(int side);
+    void stop();
+
+signals:
+    // DirectConnection only: emitted on the simulation thread right after
+    // a new snapshot went out.
+    void snapshotPublished();
+
+    // DirectConnection only: emitted on a pool thread once the level after
+    // the one being played is loaded and compiled.
+    void levelPreloaded(int level, const BitGrid &walls);
+
+    void statsChanged(int score, int lives, int level);
+    void levelCleared();
+    void gameOver();
+
+    // Ticking from now on, right after the level's first snapshot
+    void levelStarted();
+
+    // The level could not be started; nothing is running
+    void levelFailed(const QString &reason);
+
+private:
+    // ---------- INIT ----------
+    void beginLevel();
+    void preloadLevel(int levelNumber);
+    bool initMaze(int levelNumber);
+    void initFood();
+    void initEnemies();
+    void streamWorld();
+    void worldBuilt();
+    QRect streamedArea() const;
+
+    // ---------- GAMEPLAY ----------
+    bool isWalkable(int x, int y) const;
+    bool aStarNextStep(int sx, int sy, int tx, int ty, int &nx, int &ny,
+                       const QRect &bounds = QRect());
+    bool chaseStep(const Enemy &e, int &dx, int &dy);
+    void moveEnemies();
+    void eatAt(int x, int y);
+    void checkCollisions();
+    void drainInput(qint64 untilNs);
+    void applyInput(const InputEvent &e);
+    void movePlayer();
+    void tick(qint64 deadlineNs);
+    void advance();
+    void scheduleWake();
+    void holdPositions();
+    void playSfx(AudioMixer::Sound id, float volume);
+    void publish(GameSnapshot::State state);
+
+    LevelLibrary &library;
+    LevelTemplate level;        // shared, never written; enemies respawn from here
+    int loadedKey = 0;          // level number, or -side for a mega maze
+    int megaSide = 0;
+    MazeRouter router;          // over level->graph
+
+    // Cell-by-cell A* scratch over the searched rect, valid where
+    // stamp == stepEpoch; dx, dy is the first step taken from the start
+    struct StepScratch {
+        quint32 stamp = 0;
+        int g = 0;
+        qint8 dx = 0, dy = 0;
+        bool closed = false;
+    };
+    struct StepEntry {
+        int f, g, x, y;
+        // Min-heap on f, deeper first on ties
+        bool operator<(const StepEntry &o) const { return f != o.f ? f > o.f : g < o.g; }
+    };
+    QVector<StepScratch> stepScratch;
+    std::vector<StepEntry> stepHeap;
+    quint32 stepEpoch = 0;
+    ChunkedWorld world;         // open while a mega maze streams
+    QVector<QRect> wanted;      // areas handed to world each tick
+
+    // Next level, loading on the global pool while this one is played
+    QFuture<LevelTemplate> preload;
+    int preloadNumber = 0;
+
+    // Mega-maze world file, written on the global pool before its level
+    // can start; the result is dropped if the start was called off
+    QFutureWatcher<QString> *worldBuild;
+    bool awaitingWorld = false;
+    QString megaPath;
+
+    int rows = 0, cols = 0;
+    BitGrid maze;               // empty while streaming
+    BitGrid food;               // pellets left, shares level->food until eaten
+    int foodLeft = 0;
+    QVector<Enemy> enemies;
+
+    int playerX = 1, playerY = 1;
+    int playerDirX = 0, playerDirY = 0;
+    bool mouthOpen = false;
+    int currentLevel = 1;
+
+    // Where everything stood before the current tick, for interpolation
+    QPoint playerFrom{1, 1};
+    QVector<QPoint> enemiesFrom;
+    qint64 tickNs = 0;
+    int lives = 3;
+    int score = 0;
+    quint64 tickCount = 0;
+
+    // Input state, simulation thread only
+    struct BufferedTurn {
+        int dx = 0, dy = 0;
+        quint64 releasedTick = 0;
+        qint64 pressNs = 0;
+        bool valid = false;
+    };
+    quint8 heldKeys = 0;        // one bit per direction
+    bool tapPending = false;    // a press this tick, even if already released
+    BufferedTurn turn;
+    QVector<InputEvent> pendingInput;   // popped, but stamped after the tick
+
+    mutable QMutex statsLock;
+    TimingHistogram inputLatency;
+    TickStats tickTimes;
+    qint64 aiNs = 0;            // moveEnemies() in the last tick
+
+    // Accumulator clock, simulation thread only
+    QTimer *timer;
+    qint64 periodNs = qint64(1e9 / kDefaultTickHz);
+    qint64 nextTickNs = 0;
+    bool running = false;
+    AudioMixer *mixer = nullptr;
+    SpscRing<InputEvent> input{256};
+    TripleBuffer<GameSnapshot> published;
+};
+
+#endif // GAMESIMULATION_H
@@ -0,0 +1,137 @@
+#ifndef GAMETYPES_H
+#define GAMETYPES_H
+
+#include <QByteArray>
+#include <QColor>
+#include <QPair>
+#include <QPoint>
+#include <QRect>
+#include <QSet>
+#include <QVector>
+#include <chrono>
+
+// ==============================
+// 🕹 GAME LOGIC STRUCTURES
+// ==============================
+
+enum class EnemyType { Simple, Smart };
+
+struct Enemy {
+    int x, y;
+    int dx, dy;
+    QColor color;
+    EnemyType type;
+    QRect habitat;
+    int moveInterval;
+    int cooldown;
+    bool chasing = false;   // planned at a junction, now following a corridor
+};
+
+// One bit per cell, row-major (bit x%8 of byte x/8): walls, reachable
+// cells, pellets. Implicitly shared; fromRawData() borrows a mapped level
+// without copying until the first set().
+class BitGrid
+{
+public:
+    BitGrid() = default;
+    BitGrid(int cols, int rows)
+        : w(cols), h(rows), bytes(strideFor(cols) * rows, '\0') {}
+
+    // bits has to outlive every copy of the grid
+    static BitGrid fromRawData(int cols, int rows, const uchar *bits)
+    {
+        BitGrid g;
+        g.w = cols;
+        g.h = rows;
+        g.bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(bits),
+                                          strideFor(cols) * rows);
+        return g;
+    }
+
+    static int strideFor(int cols) { return (cols + 7) / 8; }
+
+    int cols() const { return w; }
+    int rows() const { return h; }
+    int stride() const { return strideFor(w); }
+    bool isEmpty() const { return w <= 0 || h <= 0; }
+
+    bool contains(int x, int y) const { return uint(x) < uint(w) && uint(y) < uint(h); }
+
+    // Cells outside the grid read as clear
+    bool test(int x, int y) const
+    {
+        if (!contains(x, y)) return false;
+        return (uchar(bytes.constData()[y * stride() + (x >> 3)]) >> (x & 7)) & 1;
+    }
+
+    // For wall grids: outside the grid counts as wall
+    bool isWall(int x, int y) const { return !contains(x, y) || test(x, y); }
+
+    void set(int x, int y, bool on = true)
+    {
+        if (!contains(x, y)) return;
+        char &b = bytes.data()[y * stride() + (x >> 3)];
+        b = on ? char(b | (1 << (x & 7))) : char(b & ~(1 << (x & 7)));
+    }
+
+    int count() const
+    {
+        int n = 0;
+        for (char b : bytes)
+            n += qPopulationCount(quint8(b));
+        return n;
+    }
+
+    const uchar *constBits() const { return reinterpret_cast<const uchar *>(bytes.constData()); }
+    const QByteArray &data() const { return bytes; }
+
+    // Whole rows at once; detaches like set()
+    uchar *bits() { return reinterpret_cast<uchar *>(bytes.data()); }
+
+private:
+    int w = 0, h = 0;
+    QByteArray bytes;
+};
+
+// Monotonic nanoseconds, comparable across every thread in the game
+inline qint64 monotonicNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Arrow key change from the GUI, handed to the simulation thread. The
+// timestamp is taken when Qt delivered the key, not when a tick saw it.
+struct InputEvent {
+    enum Kind : quint8 { Press, Release };
+    Kind kind;
+    qint8 dx, dy;
+    qint64 timeNs;
+};
+
+// Everything a frame needs, published by the simulation after each tick.
+// The containers are implicitly shared, so copying one is cheap.
+//
+// Positions from the tick before ride along so the renderer can slide
+// sprites from there to here over one tick period, starting at tickNs.
+struct GameSnapshot {
+    enum State : quint8 { Idle, Running, Won, Lost };
+
+    quint64 tick = 0;
+    qint64 tickNs = 0;              // deadline this tick was simulated for
+    qint64 periodNs = 0;
+    State state = Idle;
+    int rows = 0, cols = 0;
+    BitGrid maze;
+    BitGrid food;                   // pellets left
+    QPoint gridOrigin;              // where maze/food start on the board
+    QVector<Enemy> enemies;
+    QVector<QPoint> enemiesFrom;    // same order as enemies
+    int playerX = 1, playerY = 1;
+    int playerFromX = 1, playerFromY = 1;
+    int playerDirX = 0, playerDirY = 0;
+    bool mouthOpen = false;
+    int score = 0, lives = 3, level = 1;
+};
+
+#endif // GAMETYPES_H
@@ -0,0 +1,263 @@
+#include "levelcache.h"
+#include "levelcompiler.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = { 'P', 'M', 'L', 'C' };
+constexpr int kHeaderSize = 64;     // keeps the payload 8-byte aligned
+constexpr int kKeySize = 32;
+
+inline qint64 layerStride(qint64 width) { return (width + 3) & ~qint64(3); }
+
+void addInt(QCryptographicHash &h, qint64 v)
+{
+    char b[8];
+    qToLittleEndian<qint64>(v, b);
+    h.addData(QByteArray::fromRawData(b, 8));
+}
+
+void addGrid(QCryptographicHash &h, const BitGrid &g)
+{
+    addInt(h, g.cols());
+    addInt(h, g.rows());
+    h.addData(g.data());
+}
+
+} // namespace
+
+bool LevelCache::open(const QString &dir)
+{
+    QMutexLocker locker(&lock);
+    root.clear();
+    if (dir.isEmpty() || !QDir().mkpath(dir))
+        return false;
+    root = QDir(dir).absolutePath();
+    return true;
+}
+
+QString LevelCache::defaultPath()
+{
+    const QString env = qEnvironmentVariable("PACMAN_CACHE");
+    if (!env.isEmpty())
+        return env;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/levels";
+}
+
+// Only what the derived data depends on: walls, spawn, landmark count
+QByteArray LevelCache::levelKey(const LevelData &level)
+{
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    addGrid(h, level.walls);
+    addInt(h, level.playerStart.x());
+    addInt(h, level.playerStart.y());
+    addInt(h, LevelCompiler::kDefaultLandmarks);
+    return h.result();
+}
+
+QByteArray LevelCache::wallKey(const BitGrid &walls, int cellSize, const QByteArray &tile)
+{
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    addGrid(h, walls);
+    addInt(h, cellSize);
+    h.addData(tile);
+    return h.result();
+}
+
+QByteArray LevelCache::headerBytes(const Header &h)
+{
+    QByteArray b(kHeaderSize, '\0');
+    char *p = b.data();
+    std::memcpy(p, kMagic, 4);
+    qToLittleEndian<quint16>(kEngineVersion, p + 4);
+    qToLittleEndian<quint16>(h.kind, p + 6);
+    qToLittleEndian<quint32>(h.cellSize, p + 8);
+    qToLittleEndian<quint32>(h.width, p + 12);
+    qToLittleEndian<quint32>(h.height, p + 16);
+    std::memcpy(p + 24, h.key.constData(), kKeySize);
+    qToLittleEndian<quint64>(h.payloadSize, p + 56);
+    return b;
+}
+
+QString LevelCache::pathFor(const QByteArray &key, const char *suffix) const
+{
+    return root + '/' + QString::fromLatin1(key.toHex()) + QLatin1String(suffix);
+}
+
+// Stale (other engine) and damaged entries fail here the same way
+bool LevelCache::checkHeader(QFile &f, const Header &want) const
+{
+    const QByteArray b = f.read(kHeaderSize);
+    if (b.size() != kHeaderSize)
+        return false;
+    const uchar *p = reinterpret_cast<const uchar *>(b.constData());
+    const quint64 payload = qFromLittleEndian<quint64>(p + 56);
+    return std::memcmp(p, kMagic, 4) == 0
+        && qFromLittleEndian<quint16>(p + 4) == kEngineVersion
+        && qFromLittleEndian<quint16>(p + 6) == want.kind
+        && qFromLittleEndian<quint32>(p + 8) == want.cellSize
+        && qFromLittleEndian<quint32>(p + 12) == want.width
+        && qFromLittleEndian<quint32>(p + 16) == want.height
+        && std::memcmp(p + 24, want.key.constData(), kKeySize) == 0
+        && payload == quint64(f.size() - kHeaderSize)
+        && (!want.payloadSize || payload == want.payloadSize);
+}
+
+bool LevelCache::writeEntry(const QString &path, const Header &h, const QByteArray &payload,
+                            const LevelPackWriter *pack)
+{
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly) || f.write(headerBytes(h)) != kHeaderSize)
+        return false;
+    if (pack ? !pack->write(&f) : f.write(payload) != payload.size())
+        return false;
+
+    // The pack's size is only known once written; patch it in
+    const quint64 size = quint64(f.pos() - kHeaderSize);
+    char b[8];
+    qToLittleEndian<quint64>(size, b);
+    return f.seek(56) && f.write(b, 8) == 8 && f.commit();
+}
+
+void LevelCache::evict(const QString &path)
+{
+    qDebug() << "level cache: dropping" << QDir(root).relativeFilePath(path);
+    QFile::remove(path);
+}
+
+bool LevelCache::load(LevelData &level)
+{
+    const qint64 cells = qint64(level.walls.cols()) * level.walls.rows();
+    if (!isOpen() || cells < kMinCells)
+        return false;
+
+    const QByteArray key = levelKey(level);
+    QMutexLocker locker(&lock);
+    QSharedPointer<LevelPack> pack = packs.value(key);
+    if (!pack) {
+        const QString path = pathFor(key, ".lvl");
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly))
+            return false;
+        Header want;
+        want.kind = KindLevel;
+        want.width = quint32(level.walls.cols());
+        want.height = quint32(level.walls.rows());
+        want.key = key;
+        const bool ok = checkHeader(f, want);
+        f.close();
+
+        pack.reset(new LevelPack);
+        if (!ok || !pack->open(path, kHeaderSize) || pack->levelCount() != 1) {
+            pack.reset();
+            evict(path);
+            return false;
+        }
+        packs.insert(key, pack);
+    }
+
+    // A record that no longer validates, or is not this level after all
+    LevelData cached;
+    if (!pack->load(0, &cached) || cached.walls.data() != level.walls.data()
+        || cached.playerStart != level.playerStart) {
+        const QString path = pathFor(key, ".lvl");
+        packs.remove(key);
+        pack.reset();
+        evict(path);
+        return false;
+    }
+
+    level.reachable = cached.reachable;
+    level.food = cached.food;
+    level.graph = cached.graph;
+    level.landmarks = cached.landmarks;
+    return true;
+}
+
+void LevelCache::store(const LevelData &level)
+{
+    const qint64 cells = qint64(level.walls.cols()) * level.walls.rows();
+    if (!isOpen() || cells < kMinCells || !level.isCompiled())
+        return;
+
+    Header h;
+    h.kind = KindLevel;
+    h.width = quint32(level.walls.cols());
+    h.height = quint32(level.walls.rows());
+    h.key = levelKey(level);
+
+    LevelPackWriter pack;
+    pack.add(level);
+    QMutexLocker locker(&lock);
+    if (!writeEntry(pathFor(h.key, ".lvl"), h, QByteArray(), &pack))
+        qWarning() << "level cache: could not write" << pathFor(h.key, ".lvl");
+}
+
+QImage LevelCache::loadWalls(const BitGrid &walls, int cellSize, const QByteArray &tile)
+{
+    const qint64 w = qint64(walls.cols()) * cellSize, h = qint64(walls.rows()) * cellSize;
+    const qint64 bytes = layerStride(w) * h;
+    const qint64 cells = qint64(walls.cols()) * walls.rows();
+    if (!isOpen() || cells < kMinCells || bytes > kMaxWallBytes)
+        return QImage();
+
+    const QByteArray key = wallKey(walls, cellSize, tile);
+    QMutexLocker locker(&lock);
+    MappedLayer m = layers.value(key);
+    if (!m.bits) {
+        const QString path = pathFor(key, ".wall");
+        m.file.reset(new QFile(path));
+        if (!m.file->open(QIODevice::ReadOnly))
+            return QImage();
+        Header want;
+        want.kind = KindWalls;
+        want.cellSize = quint32(cellSize);
+        want.width = quint32(w);
+        want.height = quint32(h);
+        want.key = key;
+        want.payloadSize = quint64(bytes);
+        if (checkHeader(*m.file, want))
+            m.bits = m.file->map(kHeaderSize, bytes);
+        if (!m.bits) {
+            m.file->close();
+            evict(path);
+            return QImage();
+        }
+        layers.insert(key, m);
+    }
+
+    // Read-only view; drawing into it detaches a private copy
+    return QImage(m.bits, int(w), int(h), int(layerStride(w)), QImage::Format_Indexed8);
+}
+
+void LevelCache::storeWalls(const BitGrid &walls, int cellSize, const QByteArray &tile,
+                            const QImage &layer)
+{
+    const qint64 w = layer.width(), h = layer.height();
+    const qint64 stride = layerStride(w);
+    const qint64 cells = qint64(walls.cols()) * walls.rows();
+    if (!isOpen() || cells < kMinCells || stride * h > kMaxWallBytes
+        || layer.format() != QImage::Format_Indexed8)
+        return;
+
+    Header hd;
+    hd.kind = KindWalls;
+    hd.cellSize = quint32(cellSize);
+    hd.width = quint32(w);
+    hd.height = quint32(h);
+    hd.key = wallKey(walls, cellSize, tile);
+
+    QByteArray payload(stride * h, '\0');
+    for (int y = 0; y < h; ++y)
+        std::memcpy(payload.data() + y * stride, layer.constScanLine(y), w);
+
+    QMutexLocker locker(&lock);
+    if (!writeEntry(pathFor(hd.key, ".wall"), hd, payload, nullptr))
+        qWarning() << "level cache: could not write" << pathFor(hd.key, ".wall");
+}
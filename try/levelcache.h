@@ -0,0 +1,98 @@
+#ifndef LEVELCACHE_H
+#define LEVELCACHE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include "levelpack.h"
+
+// ==============================
+// 🗄 DERIVED LEVEL CACHE
+// ==============================
+
+// On-disk cache for what is slow to derive from a big level: reachable
+// cells, pellets, the junction graph, landmark tables and pre-rendered
+// wall layers. Entries are keyed by a SHA-256 of the level content (and
+// cell size plus wall tile for layers), written through QSaveFile so a
+// crash never leaves half an entry, and memory-mapped on load. An entry
+// from another engine version, or one that fails validation, is deleted
+// and counts as a miss.
+//
+// Entry file (little endian):
+//   "PMLC", u16 engine version, u16 kind, u32 cell size,
+//   u32 width, u32 height, u32 0, u8 key[32], u64 payload size, payload
+// A level payload is a one-level levels.pak; a wall payload is height
+// indexed scanlines of width rounded up to 4 bytes, as QImage has them.
+//
+// Thread safe. Mapped entries stay open until the cache is destroyed,
+// so anything loaded from it must not outlive it.
+class LevelCache
+{
+public:
+    // Bump whenever LevelCompiler changes what it produces
+    static constexpr quint16 kEngineVersion = 1;
+
+    // Smaller levels compile faster than a cache lookup
+    static constexpr qint64 kMinCells = 128 * 128;
+
+    // Wall layers above this are cheaper to redraw than to read back
+    static constexpr qint64 kMaxWallBytes = qint64(64) << 20;
+
+    LevelCache() = default;
+
+    LevelCache(const LevelCache &) = delete;
+    LevelCache &operator=(const LevelCache &) = delete;
+
+    // Creates the directory if needed
+    bool open(const QString &dir);
+    bool isOpen() const { return !root.isEmpty(); }
+    QString directory() const { return root; }
+
+    // Fills in the derived data of an uncompiled level. False on a miss.
+    bool load(LevelData &level);
+    void store(const LevelData &level);
+
+    // Indexed 8-bit layer over the mapped entry, null on a miss. tile is
+    // the wall tile the layer was drawn with.
+    QImage loadWalls(const BitGrid &walls, int cellSize, const QByteArray &tile);
+    void storeWalls(const BitGrid &walls, int cellSize, const QByteArray &tile, const QImage &layer);
+
+    // PACMAN_CACHE if set, else levels/ in the user cache directory
+    static QString defaultPath();
+
+private:
+    enum Kind : quint16 { KindLevel = 1, KindWalls = 2 };
+
+    struct Header {
+        quint16 kind = 0;
+        quint32 cellSize = 0, width = 0, height = 0;
+        QByteArray key;
+        quint64 payloadSize = 0;
+    };
+
+    static QByteArray levelKey(const LevelData &level);
+    static QByteArray wallKey(const BitGrid &walls, int cellSize, const QByteArray &tile);
+    static QByteArray headerBytes(const Header &h);
+
+    QString pathFor(const QByteArray &key, const char *suffix) const;
+    bool checkHeader(QFile &f, const Header &want) const;
+    bool writeEntry(const QString &path, const Header &h, const QByteArray &payload,
+                    const LevelPackWriter *pack);
+    void evict(const QString &path);
+
+    QString root;
+    QMutex lock;
+    QHash<QByteArray, QSharedPointer<LevelPack>> packs;
+    struct MappedLayer {
+        QSharedPointer<QFile> file;
+        const uchar *bits = nullptr;
+    };
+    QHash<QByteArray, MappedLayer> layers;
+};
+
+#endif // LEVELCACHE_H
@@ -0,0 +1,298 @@
+#include "levelcompiler.h"
+#include <QHash>
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const int kDirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+// Breadth-first distances over the reachable cells, saturated to fit u16
+QVector<quint16> distancesFrom(const BitGrid &open, int start)
+{
+    const int cols = open.cols();
+    QVector<quint16> dist(cols * open.rows(), LandmarkTable::kUnreached);
+    QVector<int> queue;
+    queue.reserve(dist.size());
+    dist[start] = 0;
+    queue.append(start);
+    for (int head = 0; head < queue.size(); ++head) {
+        const int c = queue[head];
+        const int x = c % cols, y = c / cols;
+        const quint16 next = quint16(qMin(dist[c] + 1, LandmarkTable::kUnreached - 1));
+        for (const auto &d : kDirs) {
+            const int nx = x + d[0], ny = y + d[1];
+            if (!open.test(nx, ny)) continue;
+            const int n = ny * cols + nx;
+            if (dist[n] != LandmarkTable::kUnreached) continue;
+            dist[n] = next;
+            queue.append(n);
+        }
+    }
+    return dist;
+}
+
+BitGrid floodFill(const BitGrid &walls, QPoint start)
+{
+    BitGrid seen(walls.cols(), walls.rows());
+    if (walls.isWall(start.x(), start.y()))
+        return seen;
+
+    QVector<QPoint> stack{ start };
+    seen.set(start.x(), start.y());
+    while (!stack.isEmpty()) {
+        const QPoint p = stack.takeLast();
+        for (const auto &d : kDirs) {
+            const int nx = p.x() + d[0], ny = p.y() + d[1];
+            if (walls.isWall(nx, ny) || seen.test(nx, ny)) continue;
+            seen.set(nx, ny);
+            stack.append(QPoint(nx, ny));
+        }
+    }
+    return seen;
+}
+
+int openNeighbours(const BitGrid &open, int x, int y)
+{
+    int n = 0;
+    for (const auto &d : kDirs)
+        n += open.test(x + d[0], y + d[1]);
+    return n;
+}
+
+// Nodes wherever a corridor does not simply continue: junctions and dead
+// ends. A level that is one closed loop gets its spawn as the only node.
+// The cell table doubles as the node lookup and is built in place, so a
+// 4096x4096 level never holds it twice.
+LevelGraph buildGraph(const BitGrid &open, QPoint spawn)
+{
+    const int cols = open.cols(), rows = open.rows();
+    LevelGraph g;
+    g.cellData = QByteArray(qsizetype(cols) * rows * qsizetype(sizeof(GraphCell)), Qt::Uninitialized);
+    GraphCell *cells = reinterpret_cast<GraphCell *>(g.cellData.data());
+    std::fill(cells, cells + qsizetype(cols) * rows, GraphCell{ GraphCell::kNone, 0 });
+
+    QVector<GraphNode> nodes;
+    auto addNode = [&](int x, int y) {
+        cells[qsizetype(y) * cols + x] = GraphCell{ GraphCell::kNodeBit | quint32(nodes.size()), 0 };
+        nodes.append(GraphNode{ quint16(x), quint16(y), 0, 0, 0 });
+    };
+    for (int y = 0; y < rows; ++y)
+        for (int x = 0; x < cols; ++x)
+            if (open.test(x, y) && openNeighbours(open, x, y) != 2)
+                addNode(x, y);
+    if (nodes.isEmpty() && open.test(spawn.x(), spawn.y()))
+        addNode(spawn.x(), spawn.y());
+
+    QVector<GraphEdge> edges;
+    for (int i = 0; i < nodes.size(); ++i) {
+        GraphNode &n = nodes[i];
+        n.firstEdge = quint32(edges.size());
+        for (const auto &d : kDirs) {
+            int px = n.x, py = n.y;
+            int x = n.x + d[0], y = n.y + d[1];
+            if (!open.test(x, y)) continue;
+
+            // Follow the corridor; every cell on it has exactly two exits.
+            // The first edge to walk a corridor is the one its cells map to.
+            quint32 length = 1;
+            while (!cells[qsizetype(y) * cols + x].isNode()) {
+                GraphCell &c = cells[qsizetype(y) * cols + x];
+                if (c.ref == GraphCell::kNone)
+                    c = GraphCell{ quint32(edges.size()), length };
+                for (const auto &s : kDirs) {
+                    const int nx = x + s[0], ny = y + s[1];
+                    if ((nx != px || ny != py) && open.test(nx, ny)) {
+                        px = x; py = y;
+                        x = nx; y = ny;
+                        break;
+                    }
+                }
+                ++length;
+            }
+            GraphEdge e{};
+            e.to = cells[qsizetype(y) * cols + x].ref & ~GraphCell::kNodeBit;
+            e.length = length;
+            e.dx = qint8(d[0]);
+            e.dy = qint8(d[1]);
+            edges.append(e);
+        }
+        n.edgeCount = quint16(edges.size() - n.firstEdge);
+    }
+
+    g.nodeData = QByteArray(reinterpret_cast<const char *>(nodes.constData()),
+                            nodes.size() * qsizetype(sizeof(GraphNode)));
+    g.edgeData = QByteArray(reinterpret_cast<const char *>(edges.constData()),
+                            edges.size() * qsizetype(sizeof(GraphEdge)));
+    return g;
+}
+
+// Farthest-point picks: each landmark is the reachable cell furthest from
+// the ones chosen so far, starting from the spawn
+LandmarkTable buildLandmarks(const BitGrid &open, QPoint spawn, int wanted)
+{
+    const int cols = open.cols();
+    LandmarkTable t;
+    t.cells = cols * open.rows();
+
+    QVector<quint16> nearest = distancesFrom(open, spawn.y() * cols + spawn.x());
+    for (int l = 0; l < wanted; ++l) {
+        int far = -1;
+        for (int c = 0; c < nearest.size(); ++c)
+            if (nearest[c] != LandmarkTable::kUnreached && nearest[c] > 0
+                && (far < 0 || nearest[c] > nearest[far]))
+                far = c;
+        if (far < 0) break;
+
+        const QVector<quint16> dist = distancesFrom(open, far);
+        t.data.append(reinterpret_cast<const char *>(dist.constData()),
+                      dist.size() * qsizetype(sizeof(quint16)));
+        ++t.count;
+        for (int c = 0; c < nearest.size(); ++c)
+            nearest[c] = qMin(nearest[c], dist[c]);
+    }
+    return t;
+}
+
+QColor defaultColor(int index)
+{
+    static const Qt::GlobalColor palette[] = {
+        Qt::red, Qt::magenta, Qt::cyan, Qt::green, Qt::blue, Qt::white
+    };
+    return palette[index % int(std::size(palette))];
+}
+
+bool parseEnemy(const QString &spec, Enemy &e, QString *why)
+{
+    for (const QString &tok : spec.split(' ', Qt::SkipEmptyParts)) {
+        const QString key = tok.section('=', 0, 0).toLower();
+        const QString value = tok.section('=', 1);
+        if (key == "simple") e.type = EnemyType::Simple;
+        else if (key == "smart") e.type = EnemyType::Smart;
+        else if (key == "left") { e.dx = -1; e.dy = 0; }
+        else if (key == "right") { e.dx = 1; e.dy = 0; }
+        else if (key == "up") { e.dx = 0; e.dy = -1; }
+        else if (key == "down") { e.dx = 0; e.dy = 1; }
+        else if (key == "none") { e.dx = 0; e.dy = 0; }
+        else if (key == "interval") e.moveInterval = qBound(0, value.toInt(), 255);
+        else if (key == "cooldown") e.cooldown = qBound(0, value.toInt(), 255);
+        else if (key == "habitat") {
+            const QStringList r = value.split(',');
+            if (r.size() != 4) { *why = "habitat wants x,y,w,h"; return false; }
+            e.habitat = QRect(r[0].toInt(), r[1].toInt(), r[2].toInt(), r[3].toInt());
+        } else if (const QColor c(tok); c.isValid()) {
+            e.color = c;
+        } else {
+            *why = QString("unknown enemy option '%1'").arg(tok);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace LevelCompiler {
+
+void compile(LevelData &level, int landmarks)
+{
+    const int cols = level.walls.cols(), rows = level.walls.rows();
+    level.reachable = floodFill(level.walls, level.playerStart);
+
+    // Pellets everywhere Pac-Man can get to, except the spawn itself
+    level.food = level.reachable;
+    level.food.set(level.playerStart.x(), level.playerStart.y(), false);
+
+    level.graph = buildGraph(level.reachable, level.playerStart);
+    level.landmarks = LandmarkTable();
+    if (qint64(cols) * rows <= kMaxLandmarkCells)
+        level.landmarks = buildLandmarks(level.reachable, level.playerStart, landmarks);
+}
+
+bool parse(const QString &text, QVector<LevelData> *out, QString *error)
+{
+    const QStringList lines = text.split('\n');
+    int lineNo = 0;
+    auto fail = [&](const QString &why) {
+        if (error) *error = QString("line %1: %2").arg(lineNo).arg(why);
+        return false;
+    };
+
+    static const QRegularExpression enemyLine("^enemy\\s+([a-z])\\s*:(.*)$");
+    int i = 0;
+    while (i < lines.size()) {
+        LevelData level;
+        level.name = QString("Level %1").arg(out->size() + 1);
+        QHash<QChar, Enemy> specs;
+        QStringList map;
+        bool inMap = false;
+
+        for (; i < lines.size(); ++i) {
+            lineNo = i + 1;
+            QString line = lines[i];
+            if (line.endsWith('\r')) line.chop(1);
+            if (line.trimmed() == "---") { ++i; break; }
+            if (inMap) { map.append(line); continue; }
+
+            const QString t = line.trimmed();
+            if (t.isEmpty() || t.startsWith(';')) continue;
+            if (t == "map:") { inMap = true; continue; }
+            if (t.startsWith("name:")) { level.name = t.mid(5).trimmed(); continue; }
+
+            const QRegularExpressionMatch m = enemyLine.match(t);
+            if (!m.hasMatch())
+                return fail(QString("expected name:, enemy x: or map:, got '%1'").arg(t));
+            Enemy e{ 0, 0, 1, 0, defaultColor(m.captured(1)[0].unicode() - 'a'),
+                     EnemyType::Simple, QRect(), 1, 0 };
+            QString why;
+            if (!parseEnemy(m.captured(2), e, &why))
+                return fail(why);
+            specs.insert(m.captured(1)[0], e);
+        }
+
+        while (!map.isEmpty() && map.last().trimmed().isEmpty())
+            map.removeLast();
+        if (map.isEmpty()) {
+            if (!inMap && specs.isEmpty()) continue;   // blank section
+            return fail(QString("%1 has no map").arg(level.name));
+        }
+
+        int cols = 0;
+        for (const QString &row : map) cols = qMax(cols, int(row.size()));
+        const int rows = int(map.size());
+        if (cols > LevelPack::kMaxSide || rows > LevelPack::kMaxSide)
+            return fail(QString("%1 is larger than %2 cells a side").arg(level.name).arg(LevelPack::kMaxSide));
+
+        level.walls = BitGrid(cols, rows);
+        bool haveSpawn = false;
+        for (int y = 0; y < rows; ++y)
+            for (int x = 0; x < cols; ++x) {
+                const QChar c = x < map[y].size() ? map[y][x] : QChar('#');
+                if (c == '#') {
+                    level.walls.set(x, y);
+                } else if (c == 'P') {
+                    if (haveSpawn) return fail(QString("%1 has two P spawns").arg(level.name));
+                    level.playerStart = QPoint(x, y);
+                    haveSpawn = true;
+                } else if (c >= 'a' && c <= 'z') {
+                    Enemy e = specs.value(c, Enemy{ 0, 0, 1, 0, defaultColor(c.unicode() - 'a'),
+                                                    EnemyType::Simple, QRect(), 1, 0 });
+                    e.x = x;
+                    e.y = y;
+                    if (e.habitat.isNull()) e.habitat = QRect(0, 0, cols, rows);
+                    level.enemies.append(e);
+                } else if (c != '.' && c != ' ') {
+                    return fail(QString("%1: unknown map cell '%2'").arg(level.name).arg(c));
+                }
+            }
+        if (!haveSpawn)
+            return fail(QString("%1 has no P spawn").arg(level.name));
+
+        out->append(level);
+    }
+    return true;
+}
+
+} // namespace LevelCompiler
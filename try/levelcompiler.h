@@ -0,0 +1,45 @@
+#ifndef LEVELCOMPILER_H
+#define LEVELCOMPILER_H
+
+#include <QString>
+#include <QVector>
+
+#include "levelpack.h"
+
+// ==============================
+// 🛠 LEVEL COMPILER
+// ==============================
+
+// Turns walls, a spawn and enemies into everything the game would
+// otherwise work out at load time: the cells Pac-Man can reach, pellets
+// on those cells only, the junction graph and landmark distance tables.
+// tools/levelpack runs it offline; the game only falls back to it for
+// levels that did not come from a pack.
+//
+// Map text, one or more levels separated by a line of "---":
+//
+//   name: Pocket
+//   enemy a: smart #ff0000 right interval=1 cooldown=0 habitat=0,0,12,12
+//   map:
+//   #########
+//   #P..a...#
+//   #########
+//
+//   '#' wall, '.' or ' ' floor, 'P' Pac-Man, 'a'..'z' an enemy spawn.
+//   enemy lines are optional: simple, palette colour, moving right,
+//   interval 1, cooldown 0, habitat = whole map. Short rows are walled.
+//   Lines starting with ';' are comments.
+namespace LevelCompiler {
+
+constexpr int kDefaultLandmarks = 4;
+
+// Above this many cells the distance tables cost more than they save
+constexpr int kMaxLandmarkCells = 1 << 20;
+
+void compile(LevelData &level, int landmarks = kDefaultLandmarks);
+
+bool parse(const QString &text, QVector<LevelData> *out, QString *error = nullptr);
+
+}
+
+#endif // LEVELCOMPILER_H
@@ -0,0 +1,149 @@
+#include "levellibrary.h"
+#include "builtinlevels.h"
+#include "chunkedworld.h"
+#include "levelcompiler.h"
+#include "mazegenerator.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+LevelLibrary::LevelLibrary(const QString &packPath, const QString &cacheDir)
+{
+    // Mapping only; levels are validated one at a time as they are played
+    if (pack.open(packPath))
+        qDebug() << "levels.pak:" << pack.levelCount() << "levels";
+    if (!cacheDir.isEmpty())
+        levelCache.open(cacheDir);
+}
+
+LevelLibrary &LevelLibrary::global()
+{
+    static LevelLibrary library(LevelPack::defaultPath(), LevelCache::defaultPath());
+    return library;
+}
+
+int LevelLibrary::levelCount() const
+{
+    return pack.levelCount() > 0 ? pack.levelCount() : BuiltinLevels::count();
+}
+
+LevelData LevelLibrary::build(int levelNumber)
+{
+    LevelData l;
+
+    // A broken record only costs that level; fall back to a built-in one
+    if (pack.levelCount() == 0 || !pack.load(levelNumber - 1, &l)) {
+        if (pack.levelCount() > 0)
+            qWarning() << "levels.pak: level" << levelNumber << "is corrupt, using a built-in level";
+        l = BuiltinLevels::level((levelNumber - 1) % BuiltinLevels::count());
+    }
+    if (!l.isCompiled() && !(cache() && cache()->load(l))) {
+        LevelCompiler::compile(l);
+        if (cache()) cache()->store(l);
+    }
+    return l;
+}
+
+// An enemy per 64x64 cells, at least four
+bool LevelLibrary::generateMegaMaze(int side, LevelData *out)
+{
+    MazeGenerator::Options o;
+    o.style = MazeGenerator::Style::Braided;
+    o.cols = o.rows = side;
+    o.enemies = qMax(4, int(qint64(side) * side / 4096));
+    if (!MazeGenerator::generate(kMegaMazeSeed, quint64(side), o, out)) {
+        qWarning() << "mega maze: no valid" << side << "x" << side << "maze";
+        return false;
+    }
+    out->name = QString("Mega %1").arg(side);
+    return true;
+}
+
+LevelData LevelLibrary::buildMegaMaze(int side)
+{
+    LevelData l;
+    if (!generateMegaMaze(side, &l))
+        return build(1);
+    if (!(cache() && cache()->load(l))) {
+        LevelCompiler::compile(l);
+        if (cache()) cache()->store(l);
+    }
+    return l;
+}
+
+template <typename Build>
+LevelTemplate LevelLibrary::fetch(QHash<int, QWeakPointer<const LevelData>> &from, int key,
+                                  Build &&build)
+{
+    {
+        QMutexLocker locker(&lock);
+        if (LevelTemplate t = from.value(key).toStrongRef())
+            return t;
+    }
+
+    // Two sessions may race to build the same level; the first one in wins
+    LevelTemplate built(new LevelData(build()));
+    QMutexLocker locker(&lock);
+    if (LevelTemplate t = from.value(key).toStrongRef())
+        return t;
+    from.insert(key, built);
+    return built;
+}
+
+LevelTemplate LevelLibrary::level(int levelNumber)
+{
+    if (levelNumber <= 0 || levelNumber > levelCount())
+        levelNumber = 1;
+    return fetch(loaded, levelNumber, [&] { return build(levelNumber); });
+}
+
+LevelTemplate LevelLibrary::megaMaze(int side)
+{
+    side = qBound(25, side, LevelPack::kMaxSide);
+    return fetch(megaMazes, side, [&] { return buildMegaMaze(side); });
+}
+
+// Generated mazes have every open cell reachable, so the world needs no
+// compile: pellets go on every open cell but the spawn
+QString LevelLibrary::megaWorld(int side)
+{
+    side = qBound(25, side, LevelPack::kMaxSide);
+
+    QMutexLocker locker(&worldLock);
+    QString dir;
+    if (cache()) {
+        dir = cache()->directory();
+    } else {
+        if (!worldDir)
+            worldDir.reset(new QTemporaryDir(QDir::tempPath() + "/pacman-XXXXXX"));
+        if (!worldDir->isValid()) {
+            qWarning() << "mega maze: no temporary directory:" << worldDir->errorString();
+            return QString();
+        }
+        dir = worldDir->path();
+    }
+    const QString path = QString("%1/mega-%2-%3-v%4.world")
+                             .arg(dir).arg(kMegaMazeSeed).arg(side).arg(kMegaMazeVersion);
+
+    ChunkedWorld existing;
+    if (existing.open(path))
+        return path;
+
+    LevelData l;
+    QString error;
+    if (!generateMegaMaze(side, &l))
+        return QString();
+    if (!ChunkedWorld::write(path, l, &error)) {
+        qWarning() << "mega maze:" << path << error;
+        return QString();
+    }
+
+    // Boards of this size from an older version are dead weight now
+    const QDir d(dir);
+    const QStringList stale = d.entryList({ QString("mega-*-%1.world").arg(side),
+                                            QString("mega-*-%1-v*.world").arg(side) }, QDir::Files);
+    for (const QString &name : stale)
+        if (d.filePath(name) != path)
+            QFile::remove(d.filePath(name));
+    return path;
+}
@@ -0,0 +1,84 @@
+#ifndef LEVELLIBRARY_H
+#define LEVELLIBRARY_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QTemporaryDir>
+#include <QWeakPointer>
+#include <memory>
+
+#include "levelcache.h"
+#include "levelpack.h"
+
+// ==============================
+// 📚 LEVEL LIBRARY
+// ==============================
+
+// A compiled level, never modified once handed out: walls, spawns, the
+// starting pellets and every precomputed table. Sessions hold one of
+// these and keep only their own progress (pellets eaten, enemies moved)
+// on top, in copy-on-write containers that share the template's data
+// until the first change.
+using LevelTemplate = QSharedPointer<const LevelData>;
+
+// One per process: maps levels.pak and the level cache once, and hands
+// out the same template to every session playing a level. Templates stay
+// loaded while any session holds them and are dropped after the last one
+// lets go. Thread safe; loading and compiling happen outside the lock.
+class LevelLibrary
+{
+public:
+    LevelLibrary(const QString &packPath, const QString &cacheDir);
+
+    LevelLibrary(const LevelLibrary &) = delete;
+    LevelLibrary &operator=(const LevelLibrary &) = delete;
+
+    // levels.pak and cache from their default paths, opened on first use
+    static LevelLibrary &global();
+
+    // From levels.pak when there is one, else the built-in levels
+    int levelCount() const;
+
+    // 1-based; out of range gives level 1. Never null.
+    LevelTemplate level(int levelNumber);
+
+    // Generated side x side braided maze, the same one every time. Up to
+    // LevelPack::kMaxSide; the first call at a size takes a while.
+    LevelTemplate megaMaze(int side);
+
+    // The same maze as a ChunkedWorld file, for playing it streamed. Kept
+    // in the cache directory, or without one in a private temporary
+    // directory removed with the library, and written on first use. The
+    // name carries kMegaMazeVersion, so a stale board is never reused.
+    // Empty if it could not be made.
+    QString megaWorld(int side);
+
+    // Null when the cache directory could not be created
+    LevelCache *cache() { return levelCache.isOpen() ? &levelCache : nullptr; }
+
+    // Fixed, so a size is always the same maze and hits the level cache
+    static constexpr quint64 kMegaMazeSeed = 4096;
+
+    // Bump whenever MazeGenerator or generateMegaMaze() would make a
+    // different board from the same seed
+    static constexpr int kMegaMazeVersion = 1;
+
+private:
+    LevelData build(int levelNumber);
+    bool generateMegaMaze(int side, LevelData *out);
+    LevelData buildMegaMaze(int side);
+    template <typename Build>
+    LevelTemplate fetch(QHash<int, QWeakPointer<const LevelData>> &from, int key, Build &&build);
+
+    LevelPack pack;
+    LevelCache levelCache;
+    QMutex lock;
+    QMutex worldLock;           // one megaWorld() writer at a time
+    std::unique_ptr<QTemporaryDir> worldDir;   // without a cache, made on first use
+    QHash<int, QWeakPointer<const LevelData>> loaded;
+    QHash<int, QWeakPointer<const LevelData>> megaMazes;   // by side
+};
+
+#endif // LEVELLIBRARY_H
@@ -0,0 +1,264 @@
+#include "levelpack.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN,
+              "levels.pak graphs and tables are used in place and stored little endian");
+static_assert(sizeof(GraphNode) == 12 && sizeof(GraphEdge) == 12 && sizeof(GraphCell) == 8,
+              "graph layout is part of the file format");
+
+namespace {
+
+constexpr char kMagic[4] = { 'P', 'M', 'L', 'V' };
+constexpr quint16 kVersion = 3;
+constexpr int kHeaderSize = 16;
+constexpr int kIndexEntrySize = 16;
+constexpr int kLevelHeaderSize = 64;
+constexpr int kNameOffset = 32;
+constexpr int kEnemySize = LevelPack::kEnemyRecordSize;
+constexpr int kNameSize = 32;
+
+inline quint16 u16(const uchar *p) { return qFromLittleEndian<quint16>(p); }
+inline quint32 u32(const uchar *p) { return qFromLittleEndian<quint32>(p); }
+inline quint64 align4(quint64 n) { return (n + 3) & ~quint64(3); }
+
+QByteArray rawBytes(const uchar *p, quint64 size)
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(p), qsizetype(size));
+}
+
+} // namespace
+
+LevelPack::~LevelPack()
+{
+    close();
+}
+
+bool LevelPack::open(const QString &path, qint64 offset)
+{
+    close();
+    file.setFileName(path);
+    if (offset < 0 || !file.open(QIODevice::ReadOnly))
+        return false;
+
+    length = file.size() - offset;
+    base = length >= kHeaderSize ? file.map(offset, length) : nullptr;
+    if (!base) {
+        close();
+        return false;
+    }
+
+    // Header and index bounds only; records are checked as they are loaded
+    const quint16 version = qFromLittleEndian<quint16>(base + 4);
+    const quint32 n = qFromLittleEndian<quint32>(base + 8);
+    if (std::memcmp(base, kMagic, 4) != 0 || version != kVersion
+        || n > quint64(length - kHeaderSize) / kIndexEntrySize) {
+        close();
+        return false;
+    }
+    count = int(n);
+    return true;
+}
+
+void LevelPack::close()
+{
+    if (base)
+        file.unmap(const_cast<uchar *>(base));
+    file.close();
+    base = nullptr;
+    length = 0;
+    count = 0;
+}
+
+bool LevelPack::load(int index, LevelData *out) const
+{
+    if (!base || index < 0 || index >= count)
+        return false;
+
+    const uchar *entry = base + kHeaderSize + qint64(index) * kIndexEntrySize;
+    const quint64 offset = qFromLittleEndian<quint64>(entry);
+    const quint64 size = qFromLittleEndian<quint64>(entry + 8);
+    if (offset > quint64(length) || size > quint64(length) - offset || size < kLevelHeaderSize)
+        return false;
+
+    const uchar *rec = base + offset;
+    const int cols = u16(rec), rows = u16(rec + 2);
+    const int px = u16(rec + 4), py = u16(rec + 6);
+    const int enemyCount = u16(rec + 8);
+    const int landmarkCount = u16(rec + 12);
+    const quint32 nodeCount = u32(rec + 16), edgeCount = u32(rec + 20);
+    if (cols < 1 || rows < 1 || cols > kMaxSide || rows > kMaxSide)
+        return false;
+
+    // Section sizes in 64 bits so a hostile count cannot wrap
+    const quint64 cells = quint64(cols) * rows;
+    const quint64 bitsSize = quint64(BitGrid::strideFor(cols)) * rows;
+    const quint64 bitsAt = kLevelHeaderSize + quint64(enemyCount) * kEnemySize;
+    const quint64 nodesAt = align4(bitsAt + 3 * bitsSize);
+    const quint64 edgesAt = nodesAt + quint64(nodeCount) * sizeof(GraphNode);
+    const quint64 cellsAt = edgesAt + quint64(edgeCount) * sizeof(GraphEdge);
+    const quint64 tablesAt = cellsAt + cells * sizeof(GraphCell);
+    if (tablesAt + quint64(landmarkCount) * cells * 2 > size)
+        return false;
+
+    LevelData l;
+    l.walls = BitGrid::fromRawData(cols, rows, rec + bitsAt);
+    l.reachable = BitGrid::fromRawData(cols, rows, rec + bitsAt + bitsSize);
+    l.food = BitGrid::fromRawData(cols, rows, rec + bitsAt + 2 * bitsSize);
+    if (!l.reachable.test(px, py))
+        return false;
+
+    l.graph.nodeData = rawBytes(rec + nodesAt, edgesAt - nodesAt);
+    l.graph.edgeData = rawBytes(rec + edgesAt, cellsAt - edgesAt);
+    l.graph.cellData = rawBytes(rec + cellsAt, tablesAt - cellsAt);
+    const GraphNode *nodes = l.graph.nodes();
+    for (quint32 i = 0; i < nodeCount; ++i)
+        if (nodes[i].x >= cols || nodes[i].y >= rows
+            || quint64(nodes[i].firstEdge) + nodes[i].edgeCount > edgeCount)
+            return false;
+    const GraphEdge *edges = l.graph.edges();
+    for (quint32 i = 0; i < edgeCount; ++i)
+        if (edges[i].to >= nodeCount || edges[i].length < 1)
+            return false;
+    const GraphCell *map = l.graph.cells();
+    for (quint64 i = 0; i < cells; ++i) {
+        const GraphCell &c = map[i];
+        if (c.ref == GraphCell::kNone) continue;
+        const bool ok = c.isNode()
+            ? (c.ref & ~GraphCell::kNodeBit) < nodeCount && c.offset == 0
+            : c.ref < edgeCount && c.offset >= 1 && c.offset < edges[c.ref].length;
+        if (!ok)
+            return false;
+    }
+
+    l.landmarks.count = landmarkCount;
+    l.landmarks.cells = int(cells);
+    l.landmarks.data = rawBytes(rec + tablesAt, quint64(landmarkCount) * cells * 2);
+
+    l.enemies.reserve(enemyCount);
+    for (int i = 0; i < enemyCount; ++i) {
+        const uchar *e = rec + kLevelHeaderSize + i * kEnemySize;
+        const Enemy en = LevelPack::readEnemy(e);
+        if (en.x >= cols || en.y >= rows || qAbs(en.dx) > 1 || qAbs(en.dy) > 1)
+            return false;
+        l.enemies.append(en);
+    }
+
+    const char *name = reinterpret_cast<const char *>(rec + kNameOffset);
+    l.name = QString::fromUtf8(name, int(qstrnlen(name, kNameSize)));
+    l.playerStart = QPoint(px, py);
+    *out = l;
+    return true;
+}
+
+Enemy LevelPack::readEnemy(const uchar *e)
+{
+    Enemy en;
+    en.x = u16(e);
+    en.y = u16(e + 2);
+    en.dx = qint8(e[4]);
+    en.dy = qint8(e[5]);
+    en.type = e[6] ? EnemyType::Smart : EnemyType::Simple;
+    en.moveInterval = e[7];
+    en.cooldown = e[8];
+    en.color = QColor::fromRgb(u32(e + 12));
+    en.habitat = QRect(u16(e + 16), u16(e + 18), u16(e + 20), u16(e + 22));
+    return en;
+}
+
+void LevelPack::writeEnemy(const Enemy &en, char *p)
+{
+    std::memset(p, 0, kEnemyRecordSize);
+    qToLittleEndian<quint16>(quint16(en.x), p);
+    qToLittleEndian<quint16>(quint16(en.y), p + 2);
+    p[4] = char(qint8(en.dx));
+    p[5] = char(qint8(en.dy));
+    p[6] = char(en.type == EnemyType::Smart ? 1 : 0);
+    p[7] = char(qBound(0, en.moveInterval, 255));
+    p[8] = char(qBound(0, en.cooldown, 255));
+    qToLittleEndian<quint32>(quint32(en.color.rgb()), p + 12);
+    qToLittleEndian<quint16>(quint16(en.habitat.x()), p + 16);
+    qToLittleEndian<quint16>(quint16(en.habitat.y()), p + 18);
+    qToLittleEndian<quint16>(quint16(en.habitat.width()), p + 20);
+    qToLittleEndian<quint16>(quint16(en.habitat.height()), p + 22);
+}
+
+QString LevelPack::defaultPath()
+{
+    const QString env = qEnvironmentVariable("PACMAN_LEVELS");
+    if (!env.isEmpty())
+        return env;
+    return QCoreApplication::applicationDirPath() + "/levels.pak";
+}
+
+// ----- writer -----
+bool LevelPackWriter::write(QIODevice *out, QString *error) const
+{
+    auto fail = [error](const QString &why) {
+        if (error) *error = why;
+        return false;
+    };
+
+    QByteArray bytes(kHeaderSize + levels.size() * kIndexEntrySize, '\0');
+    std::memcpy(bytes.data(), kMagic, 4);
+    qToLittleEndian<quint16>(kVersion, bytes.data() + 4);
+    qToLittleEndian<quint32>(quint32(levels.size()), bytes.data() + 8);
+
+    for (int i = 0; i < levels.size(); ++i) {
+        const LevelData &l = levels[i];
+        const int cols = l.walls.cols(), rows = l.walls.rows();
+        if (l.walls.isEmpty() || cols > LevelPack::kMaxSide || rows > LevelPack::kMaxSide)
+            return fail(QString("level %1: bad size %2x%3").arg(i + 1).arg(cols).arg(rows));
+        if (l.enemies.size() > 0xFFFF)
+            return fail(QString("level %1: too many enemies").arg(i + 1));
+        if (!l.isCompiled() || l.graph.cellData.size() != qsizetype(cols) * rows * qsizetype(sizeof(GraphCell)))
+            return fail(QString("level %1: not compiled").arg(i + 1));
+
+        bytes.append(QByteArray((8 - bytes.size() % 8) % 8, '\0'));
+        const qint64 offset = bytes.size();
+
+        QByteArray rec(kLevelHeaderSize + l.enemies.size() * kEnemySize, '\0');
+        char *h = rec.data();
+        qToLittleEndian<quint16>(quint16(cols), h);
+        qToLittleEndian<quint16>(quint16(rows), h + 2);
+        qToLittleEndian<quint16>(quint16(l.playerStart.x()), h + 4);
+        qToLittleEndian<quint16>(quint16(l.playerStart.y()), h + 6);
+        qToLittleEndian<quint16>(quint16(l.enemies.size()), h + 8);
+        qToLittleEndian<quint16>(quint16(l.landmarks.count), h + 12);
+        qToLittleEndian<quint32>(quint32(l.graph.nodeCount()), h + 16);
+        qToLittleEndian<quint32>(quint32(l.graph.edgeCount()), h + 20);
+        const QByteArray name = l.name.toUtf8().left(kNameSize);
+        std::memcpy(h + kNameOffset, name.constData(), name.size());
+
+        for (int e = 0; e < l.enemies.size(); ++e)
+            LevelPack::writeEnemy(l.enemies[e], h + kLevelHeaderSize + e * kEnemySize);
+        rec += l.walls.data();
+        rec += l.reachable.data();
+        rec += l.food.data();
+        rec.append(QByteArray(int(align4(rec.size()) - rec.size()), '\0'));
+        rec += l.graph.nodeData;
+        rec += l.graph.edgeData;
+        rec += l.graph.cellData;
+        rec += l.landmarks.data;
+
+        char *entry = bytes.data() + kHeaderSize + i * kIndexEntrySize;
+        qToLittleEndian<quint64>(quint64(offset), entry);
+        qToLittleEndian<quint64>(quint64(rec.size()), entry + 8);
+        bytes += rec;
+    }
+
+    if (out->write(bytes) != bytes.size())
+        return fail(out->errorString());
+    return true;
+}
+
+bool LevelPackWriter::write(const QString &path, QString *error) const
+{
+    QSaveFile f(path);
+    if (f.open(QIODevice::WriteOnly) && write(&f, error) && f.commit())
+        return true;
+    if (error && error->isEmpty()) *error = f.errorString();
+    return false;
+}
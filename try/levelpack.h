@@ -0,0 +1,191 @@
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QPoint>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "gametypes.h"
+
+// ==============================
+// 🗺 LEVEL PACK
+// ==============================
+
+// Corridor-compressed maze: nodes are junctions and dead ends, edges the
+// corridors between them, stored once from each end. Both arrays are
+// used in place from the pack, hence the fixed layout.
+struct GraphNode {
+    quint16 x, y;
+    quint32 firstEdge;
+    quint16 edgeCount;
+    quint16 pad;
+};
+
+struct GraphEdge {
+    quint32 to;         // node index
+    quint32 length;     // steps along the corridor
+    qint8 dx, dy;       // first step out of the node
+    quint8 pad[2];
+};
+
+// Where a cell sits in the graph: on node ref & ~kNodeBit, or offset
+// steps along edge ref from that edge's source node. Each corridor is
+// mapped through whichever of its two edges was stored first.
+struct GraphCell {
+    static constexpr quint32 kNone = 0xFFFFFFFFu;
+    static constexpr quint32 kNodeBit = 0x80000000u;
+
+    quint32 ref;
+    quint32 offset;
+
+    constexpr bool isNode() const { return ref != kNone && (ref & kNodeBit); }
+    constexpr bool isCorridor() const { return !(ref & kNodeBit); }
+};
+
+struct LevelGraph {
+    QByteArray nodeData;    // GraphNode[]
+    QByteArray edgeData;    // GraphEdge[]
+    QByteArray cellData;    // GraphCell per cell, row-major
+
+    int nodeCount() const { return int(nodeData.size() / qsizetype(sizeof(GraphNode))); }
+    int edgeCount() const { return int(edgeData.size() / qsizetype(sizeof(GraphEdge))); }
+    const GraphNode *nodes() const { return reinterpret_cast<const GraphNode *>(nodeData.constData()); }
+    const GraphEdge *edges() const { return reinterpret_cast<const GraphEdge *>(edgeData.constData()); }
+    const GraphCell *cells() const { return reinterpret_cast<const GraphCell *>(cellData.constData()); }
+    bool isEmpty() const { return nodeData.isEmpty() || cellData.isEmpty(); }
+
+    // The node whose edge list holds edge; nodes store theirs in order
+    int sourceOf(int edge) const
+    {
+        int lo = 0, hi = nodeCount() - 1;
+        while (lo < hi) {
+            const int mid = (lo + hi + 1) / 2;
+            if (int(nodes()[mid].firstEdge) <= edge) lo = mid;
+            else hi = mid - 1;
+        }
+        return lo;
+    }
+};
+
+// Exact maze distances from a few far-apart landmark cells. The triangle
+// inequality turns them into a lower bound between any two cells, which
+// is a much tighter A* heuristic than Manhattan distance in a maze.
+struct LandmarkTable {
+    static constexpr quint16 kUnreached = 0xFFFF;
+
+    int count = 0;
+    int cells = 0;
+    QByteArray data;        // count x cells quint16, row-major cells
+
+    quint16 distance(int landmark, int cell) const
+    {
+        return reinterpret_cast<const quint16 *>(data.constData())[qsizetype(landmark) * cells + cell];
+    }
+
+    int lowerBound(int cellA, int cellB) const
+    {
+        int best = 0;
+        for (int l = 0; l < count; ++l) {
+            const int a = distance(l, cellA), b = distance(l, cellB);
+            if (a != kUnreached && b != kUnreached)
+                best = qMax(best, qAbs(a - b));
+        }
+        return best;
+    }
+};
+
+// One playable level: walls, where Pac-Man starts and the enemy roster.
+// Enemies are stored exactly as they spawn, cooldown included. The rest
+// is derived by LevelCompiler, ahead of time for packed levels.
+struct LevelData {
+    QString name;
+    BitGrid walls;
+    QPoint playerStart{1, 1};
+    QVector<Enemy> enemies;
+
+    BitGrid reachable;          // open cells connected to the spawn
+    BitGrid food;               // pellets at the start, reachable cells only
+    LevelGraph graph;
+    LandmarkTable landmarks;
+
+    bool isCompiled() const { return !reachable.isEmpty(); }
+};
+
+// levels.pak holds any number of compiled levels in one mappable file.
+// open() only checks the header and that the index fits, so startup cost
+// does not grow with the level count; each record is validated when it is
+// loaded, and the bitmaps, graph and distance tables are then used
+// straight from the mapping.
+//
+// Layout (little endian):
+//   header   "PMLV", u16 version, u16 reserved, u32 levelCount, u32 0
+//   index    levelCount x { u64 offset, u64 size }
+//   levels   each 8-byte aligned:
+//     u16 cols, u16 rows, u16 playerX, u16 playerY,
+//     u16 enemyCount, u16 flags, u16 landmarkCount, u16 0,
+//     u32 nodeCount, u32 edgeCount, u32 0, u32 0,
+//     char name[32] (UTF-8, NUL padded)
+//     enemyCount x { u16 x, u16 y, i8 dx, i8 dy, u8 type, u8 moveInterval,
+//                    u8 cooldown, u8 pad[3], u32 rgb,
+//                    u16 habitat x, y, w, h }
+//     walls, reachable, food: rows x ((cols + 7) / 8) bytes each
+//     padding to 4, nodeCount x GraphNode, edgeCount x GraphEdge,
+//     rows x cols GraphCell
+//     landmarkCount x rows x cols u16 distances
+class LevelPack
+{
+public:
+    static constexpr int kMaxSide = 4096;
+
+    LevelPack() = default;
+    ~LevelPack();
+
+    LevelPack(const LevelPack &) = delete;
+    LevelPack &operator=(const LevelPack &) = delete;
+
+    // offset: where the pack starts inside the file, 8-byte aligned
+    bool open(const QString &path, qint64 offset = 0);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int levelCount() const { return count; }
+
+    // 0-based. False if the record is malformed; the pack stays usable.
+    // The result borrows the mapping, so it is only valid while it is open.
+    bool load(int index, LevelData *out) const;
+
+    // PACMAN_LEVELS if set, else levels.pak next to the executable
+    static QString defaultPath();
+
+    // One enemy as stored in a level record; ChunkedWorld files reuse it
+    static constexpr int kEnemyRecordSize = 24;
+    static Enemy readEnemy(const uchar *record);
+    static void writeEnemy(const Enemy &enemy, char *record);
+
+private:
+    QFile file;
+    const uchar *base = nullptr;
+    qint64 length = 0;
+    int count = 0;
+};
+
+// Build-side counterpart, used by tools/levelpack and LevelCache. Levels
+// must be compiled.
+class LevelPackWriter
+{
+public:
+    void add(const LevelData &level) { levels.append(level); }
+    bool write(const QString &path, QString *error = nullptr) const;
+
+    // Appends at the device's current position, which must be 8-byte aligned
+    bool write(QIODevice *out, QString *error = nullptr) const;
+
+private:
+    QVector<LevelData> levels;
+};
+
+#endif // LEVELPACK_H
@@ -1,9 +1,41 @@
 #include "mainwindow.h"
 #include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QSurfaceFormat>
+#include <QTimer>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// Resident set size in bytes, or -1 where we don't know how to ask
+static qint64 residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return qint64(pmc.WorkingSetSize);
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return -1;
+}
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     QApplication app(argc, argv);
 
     // Optional: smoother rendering if using animations or pixmaps
@@ -15,5 +47,11 @@ int main(int argc, char *argv[])
     window.setWindowTitle("Qt Maze Game - Pacman Style");
     window.show();
 
+    // Startup cost as seen by the player: up to the first idle event loop pass
+    QTimer::singleShot(0, &window, [&startup]() {
+        qCDebug(lcPerf) << "startup:" << startup.nsecsElapsed() / 1e6 << "ms, rss"
+                        << residentBytes() / 1024 << "KB";
+    });
+
     return app.exec();
 }
@@ -2,19 +2,11 @@
 #include <QTimer>
 #include <QRandomGenerator>
 #include <QDebug>
-#include <queue>
-#include <vector>
-#include <limits>
-#include <QMap>
 #include <QFontDatabase>
-#include <QtMultimedia/QMediaPlayer>
-#include <QtMultimedia/QAudioOutput>
-#include <QtMultimedia/QSoundEffect>
-
-// Hash for QPair<int,int> so we can use QSet
-inline uint qHash(const QPair<int,int> &key, uint seed = 0) {
-    return qHash(key.first, seed) ^ (qHash(key.second, seed) << 1);
-}
+#include <QGuiApplication>
+#include <QScreen>
+#include <QElapsedTimer>
+#include <iterator>
 
 void MainWindow::updateHUD()
 {
@@ -27,26 +19,24 @@ void MainWindow::updateHUD()
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
-    cellSize(25), rows(25), cols(25),
-    playerX(1), playerY(1), mouthOpen(0),
-    playerDirX(0), playerDirY(0), currentLevel(1),
-    gameTimer(new QTimer(this)),
+    cellSize(25), rows(25), cols(25), currentLevel(1),
     lives(3), score(0),
     exitBtn(new QPushButton("Exit", this))
 {
-    // ✅ FIX: Setup all level data first
-    setupLevels();
+    // Simulation and render stages first, everything else feeds them
+    initPipeline();
+    initAssets();
 
-    // Initialize frame
+    // Initialize frame – scales with the window, rendered at device pixels
     frame = new MyLabel(this);
-    frame->setFixedSize(cols * cellSize, rows * cellSize);
+    frame->setMinimumSize(cols * 8, rows * 8);
+    frame->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    frame->setAlignment(Qt::AlignCenter);
     frame->setStyleSheet("background:black");
+    connect(frame, &MyLabel::resized, this, &MainWindow::updateRenderScale);
 
-    // Initialize HUD and overlay
+    // Initialize HUD
     hud = new GameHUD(this);
-    crtOverlay = new CRTOverlay(frame);
-    crtOverlay->resize(frame->size());
-    crtOverlay->raise();
 
     // Stack layout
     auto layout = new QVBoxLayout();
@@ -58,9 +48,25 @@ MainWindow::MainWindow(QWidget *parent)
     QWidget *container = new QWidget(this);
     container->setLayout(layout);
     setCentralWidget(container);
+    resize(cols * cellSize, rows * cellSize + hud->sizeHint().height());
+
+    // Presentation runs at display refresh, separate from the game tick
+    frameScheduler = new FrameScheduler(this);
+    if (QScreen *s = QGuiApplication::primaryScreen())
+        frameScheduler->setRefreshRate(s->refreshRate());
+    renderThread->setFramePeriod(frameScheduler->framePeriodNs());
+    connect(frameScheduler, &FrameScheduler::frameDue, this, &MainWindow::presentLatest);
+    connect(renderThread, &RenderThread::frameReady,
+            frameScheduler, &FrameScheduler::requestFrame, Qt::QueuedConnection);
+    connect(frameScheduler, &FrameScheduler::jank, this, [](qint64 elapsedNs, qint64 budgetNs) {
+        qCDebug(lcPerf) << "jank:" << elapsedNs / 1e6 << "ms against a" << budgetNs / 1e6 << "ms frame";
+    });
 
-    // Timer setup
-    connect(gameTimer, &QTimer::timeout, this, &MainWindow::updateFrame);
+    // Band rasterizer threads (0 = one per core)
+    FrameRenderer &renderer = renderThread->renderer();
+    renderer.setThreadCount(qEnvironmentVariableIntValue("PACMAN_RENDER_THREADS"));
+    // CRT post pass (scanlines/bloom/vignette) replaces the old overlay widget
+    renderer.crtFilter().setCurvature(qEnvironmentVariableIntValue("PACMAN_CRT_CURVATURE") != 0);
 
     // Exit button setup
     exitBtn->setFocusPolicy(Qt::NoFocus);
@@ -81,13 +87,13 @@ MainWindow::MainWindow(QWidget *parent)
             showLevelSelect();
     });
 
-    // ✅ Initialize level data safely
-    initMaze(currentLevel);
-    initFood();
-    initEnemies();
     // Initialize sound system
     initAudio();
 
+    // Everything is wired up; let the rules tick and the raster run
+    simThread->start();
+    renderThread->start();
+
 
     // Show level-select overlay after startup
     QTimer::singleShot(0, this, [this]() {
@@ -98,500 +104,123 @@ MainWindow::MainWindow(QWidget *parent)
 
 
 
-MainWindow::~MainWindow() {}
-
-// ======== LEVELS (4 levels) ========
-
-void MainWindow::setupLevels() {
-    // Level 1 – custom
-    QVector<QPoint> lvl4 = {
-        QPoint(1, 2), QPoint(2, 2), QPoint(3, 2), QPoint(3, 3), QPoint(3, 4), QPoint(2, 4),
-        QPoint(6, 2), QPoint(6, 3), QPoint(6, 4), QPoint(7, 4), QPoint(8, 4), QPoint(8, 3),
-        QPoint(10, 10), QPoint(11, 10), QPoint(12, 10), QPoint(13, 10), QPoint(15, 10),
-        QPoint(14, 10), QPoint(15, 11), QPoint(15, 12), QPoint(13, 13), QPoint(14, 13),
-        QPoint(15, 13), QPoint(10, 13), QPoint(9, 13), QPoint(8, 13), QPoint(8, 12),
-        QPoint(8, 11), QPoint(8, 10), QPoint(9, 10), QPoint(10, 3), QPoint(11, 3),
-        QPoint(11, 4), QPoint(11, 5), QPoint(11, 6), QPoint(10, 6), QPoint(9, 6),
-        QPoint(16, 2), QPoint(15, 2), QPoint(15, 3), QPoint(15, 4), QPoint(15, 5),
-        QPoint(16, 5), QPoint(17, 5), QPoint(18, 5), QPoint(18, 4), QPoint(18, 3),
-        QPoint(19, 3), QPoint(20, 3), QPoint(20, 4), QPoint(13, 4), QPoint(13, 5),
-        QPoint(13, 6), QPoint(13, 7), QPoint(14, 7), QPoint(15, 7), QPoint(16, 7),
-        QPoint(17, 7), QPoint(18, 7), QPoint(20, 6), QPoint(20, 7), QPoint(22, 3),
-        QPoint(23, 3), QPoint(22, 4), QPoint(22, 5), QPoint(1, 6), QPoint(2, 6),
-        QPoint(3, 6), QPoint(3, 7), QPoint(3, 9), QPoint(3, 10), QPoint(2, 10),
-        QPoint(1, 10), QPoint(5, 8), QPoint(5, 9), QPoint(5, 10), QPoint(5, 11),
-        QPoint(6, 11), QPoint(6, 12), QPoint(6, 13), QPoint(5, 13), QPoint(4, 13),
-        QPoint(2, 13), QPoint(3, 13), QPoint(2, 12), QPoint(7, 8), QPoint(7, 7),
-        QPoint(7, 6), QPoint(6, 6), QPoint(5, 6), QPoint(17, 13), QPoint(18, 13),
-        QPoint(19, 13), QPoint(20, 13), QPoint(20, 12), QPoint(20, 11), QPoint(23, 12),
-        QPoint(20, 10), QPoint(21, 10), QPoint(22, 10), QPoint(9, 8), QPoint(10, 8),
-        QPoint(11, 8), QPoint(1, 15), QPoint(2, 15), QPoint(3, 15), QPoint(4, 15),
-        QPoint(4, 16), QPoint(4, 17), QPoint(4, 18), QPoint(5, 18), QPoint(6, 18),
-        QPoint(2, 18), QPoint(2, 17), QPoint(2, 19), QPoint(2, 20), QPoint(3, 20),
-        QPoint(4, 20), QPoint(4, 21), QPoint(7, 18), QPoint(7, 19), QPoint(6, 22),
-        QPoint(6, 21), QPoint(7, 21), QPoint(8, 21), QPoint(9, 21), QPoint(9, 16),
-        QPoint(9, 17), QPoint(9, 18), QPoint(9, 15), QPoint(7, 15), QPoint(8, 15),
-        QPoint(4, 22), QPoint(14, 8), QPoint(11, 15), QPoint(12, 15), QPoint(13, 15),
-        QPoint(14, 15), QPoint(14, 16), QPoint(14, 17), QPoint(13, 17), QPoint(12, 17),
-        QPoint(12, 18), QPoint(12, 19), QPoint(11, 19), QPoint(17, 14), QPoint(17, 15),
-        QPoint(17, 16), QPoint(17, 17), QPoint(16, 17), QPoint(16, 18), QPoint(16, 19),
-        QPoint(15, 19), QPoint(15, 20), QPoint(17, 12), QPoint(17, 11), QPoint(17, 10),
-        QPoint(15, 21), QPoint(14, 21), QPoint(13, 21), QPoint(19, 17), QPoint(19, 18),
-        QPoint(19, 19), QPoint(18, 19), QPoint(19, 16), QPoint(20, 16), QPoint(21, 16),
-        QPoint(22, 16), QPoint(22, 17), QPoint(20, 21), QPoint(21, 21), QPoint(19, 21),
-        QPoint(21, 18), QPoint(22, 18), QPoint(21, 19), QPoint(21, 20), QPoint(18, 21),
-        QPoint(18, 22), QPoint(22, 12), QPoint(22, 13), QPoint(22, 14)
-    };
-
-    // Level 2 – custom
-    QVector<QPoint> lvl2 = {
-        QPoint(5,2), QPoint(5,3), QPoint(5,4), QPoint(5,5), QPoint(4,5), QPoint(2,2), QPoint(2,3),
-        QPoint(3,2), QPoint(3,3), QPoint(3,5), QPoint(3,6), QPoint(3,7), QPoint(2,9), QPoint(3,9),
-        QPoint(3,10), QPoint(3,11), QPoint(3,12), QPoint(2,12), QPoint(16,10), QPoint(15,9),
-        QPoint(14,8), QPoint(13,8), QPoint(12,9), QPoint(11,10), QPoint(16,14), QPoint(15,15),
-        QPoint(11,14), QPoint(12,15), QPoint(13,16), QPoint(14,16), QPoint(16,11), QPoint(16,13),
-        QPoint(11,11), QPoint(11,13), QPoint(17,11), QPoint(18,11), QPoint(17,13), QPoint(18,13),
-        QPoint(5,11), QPoint(6,11), QPoint(7,11), QPoint(9,8), QPoint(9,9), QPoint(9,10),
-        QPoint(9,11), QPoint(8,11), QPoint(5,9), QPoint(6,9), QPoint(7,9), QPoint(7,6),
-        QPoint(7,7), QPoint(6,7), QPoint(6,5), QPoint(7,5), QPoint(8,3), QPoint(8,2),
-        QPoint(10,2), QPoint(9,2), QPoint(11,2), QPoint(12,2), QPoint(13,2), QPoint(11,3),
-        QPoint(11,4), QPoint(10,4), QPoint(10,5), QPoint(10,6), QPoint(14,5), QPoint(15,5),
-        QPoint(15,4), QPoint(15,3), QPoint(16,3), QPoint(17,3), QPoint(17,2), QPoint(18,2),
-        QPoint(19,2), QPoint(19,3), QPoint(19,4), QPoint(19,5), QPoint(18,5), QPoint(17,5),
-        QPoint(19,11), QPoint(20,11), QPoint(19,13), QPoint(20,13), QPoint(22,2), QPoint(22,3),
-        QPoint(21,3), QPoint(21,4), QPoint(21,5), QPoint(22,5), QPoint(22,6), QPoint(22,7),
-        QPoint(21,7), QPoint(20,7), QPoint(18,7), QPoint(19,7), QPoint(22,9), QPoint(22,10),
-        QPoint(20,9), QPoint(21,9), QPoint(19,9), QPoint(22,13), QPoint(22,14), QPoint(22,15),
-        QPoint(22,16), QPoint(21,16), QPoint(20,16), QPoint(19,16), QPoint(18,16), QPoint(18,18),
-        QPoint(18,15), QPoint(19,15), QPoint(6,14), QPoint(5,15), QPoint(4,16), QPoint(3,17),
-        QPoint(2,18), QPoint(9,14), QPoint(8,15), QPoint(7,16), QPoint(6,17), QPoint(5,18),
-        QPoint(4,19), QPoint(4,20), QPoint(4,21), QPoint(6,12), QPoint(1,18), QPoint(2,14),
-        QPoint(2,13), QPoint(2,15), QPoint(14,12), QPoint(13,12), QPoint(13,11), QPoint(14,11),
-        QPoint(14,13), QPoint(13,13), QPoint(8,19), QPoint(7,19), QPoint(7,20), QPoint(14,22),
-        QPoint(15,22), QPoint(16,22), QPoint(16,20), QPoint(16,21), QPoint(16,19), QPoint(20,18),
-        QPoint(20,19), QPoint(20,20), QPoint(19,20), QPoint(18,20), QPoint(18,21), QPoint(18,22),
-        QPoint(19,22), QPoint(20,22), QPoint(21,22), QPoint(22,22), QPoint(22,18), QPoint(22,19),
-        QPoint(22,20), QPoint(10,19), QPoint(9,19), QPoint(11,21), QPoint(11,19), QPoint(11,20),
-        QPoint(11,18), QPoint(11,17), QPoint(10,17), QPoint(11,22), QPoint(12,20), QPoint(12,19),
-        QPoint(12,21), QPoint(2,21), QPoint(3,21), QPoint(2,22), QPoint(3,22), QPoint(4,22),
-        QPoint(7,21), QPoint(7,22), QPoint(8,22), QPoint(9,22), QPoint(9,21), QPoint(16,17),
-        QPoint(17,17), QPoint(18,17), QPoint(16,18), QPoint(15,19), QPoint(14,19), QPoint(13,5),
-        QPoint(13,6), QPoint(14,6)
-    };
-
-    // Level 3 – custom
-    QVector<QPoint> lvl3 = {
-        QPoint(5,2), QPoint(5,3), QPoint(5,4), QPoint(5,5), QPoint(5,6), QPoint(19,2), QPoint(19,3),
-        QPoint(19,4), QPoint(19,5), QPoint(19,6), QPoint(7,2), QPoint(8,2), QPoint(9,2), QPoint(10,2),
-        QPoint(17,2), QPoint(16,2), QPoint(15,2), QPoint(14,2), QPoint(2,2), QPoint(3,2), QPoint(3,3),
-        QPoint(2,3), QPoint(2,5), QPoint(3,5), QPoint(3,6), QPoint(2,6), QPoint(21,2), QPoint(22,2),
-        QPoint(22,3), QPoint(21,3), QPoint(21,5), QPoint(22,5), QPoint(22,6), QPoint(21,6), QPoint(2,21),
-        QPoint(2,22), QPoint(3,22), QPoint(3,21), QPoint(5,22), QPoint(5,21), QPoint(5,20), QPoint(5,19),
-        QPoint(5,18), QPoint(2,18), QPoint(3,18), QPoint(3,19), QPoint(2,19), QPoint(22,22), QPoint(21,22),
-        QPoint(21,21), QPoint(22,21), QPoint(21,19), QPoint(21,18), QPoint(22,18), QPoint(22,19), QPoint(19,18),
-        QPoint(19,19), QPoint(19,20), QPoint(19,21), QPoint(19,22), QPoint(7,22), QPoint(8,22), QPoint(9,22),
-        QPoint(10,22), QPoint(14,22), QPoint(15,22), QPoint(16,22), QPoint(17,22), QPoint(7,4), QPoint(8,4),
-        QPoint(7,5), QPoint(16,4), QPoint(17,4), QPoint(17,5), QPoint(7,19), QPoint(7,20), QPoint(8,20),
-        QPoint(17,19), QPoint(17,20), QPoint(16,20), QPoint(4,8), QPoint(4,9), QPoint(4,10), QPoint(4,14),
-        QPoint(4,15), QPoint(4,16), QPoint(2,12), QPoint(3,12), QPoint(4,12), QPoint(5,12), QPoint(6,12),
-        QPoint(20,8), QPoint(20,9), QPoint(20,10), QPoint(20,12), QPoint(19,12), QPoint(21,12), QPoint(22,12),
-        QPoint(18,12), QPoint(20,14), QPoint(20,15), QPoint(20,16), QPoint(12,2), QPoint(12,3), QPoint(12,4),
-        QPoint(12,5), QPoint(12,6), QPoint(12,7), QPoint(12,8), QPoint(12,16), QPoint(12,17), QPoint(12,18),
-        QPoint(12,19), QPoint(12,20), QPoint(12,21), QPoint(12,22), QPoint(2,9), QPoint(22,9), QPoint(22,15),
-        QPoint(2,15), QPoint(8,11), QPoint(8,10), QPoint(8,9), QPoint(8,8), QPoint(8,13), QPoint(8,14),
-        QPoint(8,15), QPoint(8,16), QPoint(9,6), QPoint(10,6), QPoint(10,7), QPoint(10,8), QPoint(9,18),
-        QPoint(10,18), QPoint(10,17), QPoint(10,16), QPoint(10,10), QPoint(10,11), QPoint(10,12), QPoint(10,13),
-        QPoint(10,14), QPoint(5,8), QPoint(6,9), QPoint(7,10), QPoint(5,16), QPoint(6,15), QPoint(7,14),
-        QPoint(14,6), QPoint(15,6), QPoint(14,7), QPoint(14,8), QPoint(14,16), QPoint(14,17), QPoint(14,18),
-        QPoint(15,18), QPoint(14,10), QPoint(14,11), QPoint(14,12), QPoint(14,13), QPoint(16,8), QPoint(16,9),
-        QPoint(16,10), QPoint(16,11), QPoint(16,13), QPoint(16,14), QPoint(16,15), QPoint(16,16), QPoint(17,14),
-        QPoint(18,15), QPoint(19,16), QPoint(17,10), QPoint(18,9), QPoint(19,8), QPoint(9,4), QPoint(15,4),
-        QPoint(9,20), QPoint(15,20), QPoint(11,10), QPoint(13,10), QPoint(11,14), QPoint(14,14), QPoint(13,14),
-        QPoint(12,12)
-    };
-
-    // Level 4 – custom classic-ish
-    QVector<QPoint> lvl1 = {
-        QPoint(2,2), QPoint(2,3), QPoint(2,4), QPoint(2,5), QPoint(2,6), QPoint(3,2), QPoint(4,2),
-        QPoint(5,2), QPoint(6,2), QPoint(7,2), QPoint(6,3), QPoint(3,6), QPoint(2,7), QPoint(6,4),
-        QPoint(4,6), QPoint(22,2), QPoint(21,2), QPoint(20,2), QPoint(19,2), QPoint(18,2), QPoint(17,2),
-        QPoint(22,3), QPoint(22,4), QPoint(22,5), QPoint(22,6), QPoint(22,7), QPoint(18,3), QPoint(18,4),
-        QPoint(20,6), QPoint(21,6), QPoint(2,22), QPoint(2,21), QPoint(2,20), QPoint(2,19), QPoint(2,18),
-        QPoint(2,17), QPoint(3,22), QPoint(4,22), QPoint(5,22), QPoint(6,22), QPoint(7,22), QPoint(3,18),
-        QPoint(4,18), QPoint(6,21), QPoint(6,20), QPoint(22,17), QPoint(22,18), QPoint(22,19), QPoint(22,20),
-        QPoint(22,21), QPoint(22,22), QPoint(21,22), QPoint(20,22), QPoint(19,22), QPoint(18,22), QPoint(17,22),
-        QPoint(18,21), QPoint(18,20), QPoint(21,18), QPoint(20,18), QPoint(4,20), QPoint(20,20), QPoint(20,4),
-        QPoint(4,4), QPoint(6,6), QPoint(6,7), QPoint(6,8), QPoint(6,9), QPoint(6,10), QPoint(6,18),
-        QPoint(6,17), QPoint(6,16), QPoint(6,15), QPoint(6,14), QPoint(18,18), QPoint(18,17), QPoint(18,16),
-        QPoint(18,15), QPoint(18,14), QPoint(18,6), QPoint(18,7), QPoint(18,8), QPoint(18,9), QPoint(18,10),
-        QPoint(9,2), QPoint(10,2), QPoint(11,2), QPoint(13,2), QPoint(14,2), QPoint(15,2), QPoint(9,22),
-        QPoint(10,22), QPoint(11,22), QPoint(13,22), QPoint(14,22), QPoint(15,22), QPoint(4,8), QPoint(4,9),
-        QPoint(4,10), QPoint(4,14), QPoint(4,15), QPoint(4,16), QPoint(20,8), QPoint(20,9), QPoint(20,10),
-        QPoint(20,14), QPoint(20,15), QPoint(20,16), QPoint(21,12), QPoint(22,12), QPoint(2,12), QPoint(3,12),
-        QPoint(22,9), QPoint(22,10), QPoint(22,11), QPoint(2,9), QPoint(2,10), QPoint(2,11), QPoint(22,13),
-        QPoint(22,14), QPoint(22,15), QPoint(2,13), QPoint(2,14), QPoint(2,15), QPoint(9,4), QPoint(10,5),
-        QPoint(11,6), QPoint(12,7), QPoint(13,8), QPoint(14,9), QPoint(15,10), QPoint(15,4), QPoint(14,5),
-        QPoint(13,6), QPoint(11,8), QPoint(10,9), QPoint(9,10), QPoint(9,20), QPoint(10,19), QPoint(11,18),
-        QPoint(12,17), QPoint(13,16), QPoint(14,15), QPoint(15,14), QPoint(11,16), QPoint(10,15), QPoint(9,14),
-        QPoint(13,18), QPoint(14,19), QPoint(15,20), QPoint(16,6), QPoint(16,7), QPoint(16,8), QPoint(8,6),
-        QPoint(8,7), QPoint(8,8), QPoint(8,16), QPoint(8,17), QPoint(8,18), QPoint(16,16), QPoint(16,17),
-        QPoint(16,18), QPoint(12,10), QPoint(12,11), QPoint(12,12), QPoint(12,13), QPoint(12,14), QPoint(5,12),
-        QPoint(6,12), QPoint(8,12), QPoint(9,12), QPoint(15,12), QPoint(16,12), QPoint(18,12), QPoint(19,12)
-    };
-
-    levels = { lvl1, lvl2, lvl3, lvl4 };
-}
-
-void MainWindow::initMaze(int levelNumber)
+MainWindow::~MainWindow()
 {
-    maze.clear();
-    maze.resize(rows);
-    for (int y = 0; y < rows; ++y) {
-        maze[y].resize(cols, 0);
-    }
-
-    // boundary walls
-    for (int x = 0; x < cols; x++) {
-        maze[0][x] = 1;
-        maze[rows - 1][x] = 1;
-    }
-    for (int y = 0; y < rows; y++) {
-        maze[y][0] = 1;
-        maze[y][cols - 1] = 1;
-    }
-
-    // Load level walls
-    if (levelNumber <= 0 || levelNumber > levels.size())
-        levelNumber = 1;
+    // Back to front: the renderer reads the simulation's snapshots, and
+    // the simulation plays through the mixer
+    renderThread->requestStop();
+    renderThread->wait();
+    simThread->quit();
+    simThread->wait();
 
-    const QVector<QPoint> &currentWalls = levels[levelNumber - 1];
-    for (const QPoint &p : currentWalls) {
-        if (p.x() >= 0 && p.x() < cols && p.y() >= 0 && p.y() < rows)
-            maze[p.y()][p.x()] = 1;
-    }
+    // The mixer is deleted on its own thread as that thread winds down
+    audioThread->quit();
+    audioThread->wait();
 
-    playerX = 1;
-    playerY = 1;
+    // Font data lives in the archive mapping, which goes away with us
+    if (retroFontId >= 0)
+        QFontDatabase::removeApplicationFont(retroFontId);
 }
 
-void MainWindow::initFood()
-{
-    food.clear();
-    for (int y=1; y<rows-1; y++)
-        for (int x=1; x<cols-1; x++)
-            if (!maze[y][x])
-                food.insert(qMakePair(x,y));
-
-    food.remove(qMakePair(playerX, playerY));
-}
+// ==============================
+// 🧵 PIPELINE
+// ==============================
 
-void MainWindow::initEnemies()
+void MainWindow::initPipeline()
 {
-    enemies.clear();
-
-    QRect topLeft(0, 0, cols/2, rows/2);
-    QRect topRight(cols/2, 0, cols - cols/2, rows/2);
-    QRect bottomLeft(0, rows/2, cols/2, rows - rows/2);
-    QRect bottomRight(cols/2, rows/2, cols - cols/2, rows - rows/2);
-
-    // ---------- LEVEL 1 ----------
-    if (currentLevel == 1)
-    {
-        enemies.push_back(Enemy{ 1, rows-2,  1, 0, Qt::green,  EnemyType::Simple, QRect(), 1, 0 });
-        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue,   EnemyType::Simple, QRect(), 1, 1 });
-        enemies.push_back(Enemy{ cols/2, 1, 1, 0, Qt::red, EnemyType::Simple, QRect(), 1, 0 });
-        return;
-    }
-
-    // ---------- LEVEL 2 ----------
-    if (currentLevel == 2)
-    {
-        // Smart enemy in top-left quadrant
-        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::red, EnemyType::Smart, topLeft, 1, 0 });
-
-        // Simple enemies
-        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue, EnemyType::Simple, QRect(), 1, 0 });
-        enemies.push_back(Enemy{ 1, rows-2, 1, 0, Qt::green, EnemyType::Simple, QRect(), 1, 0 });
-        return;
-    }
-
-    // ---------- LEVEL 3 ----------
-    if (currentLevel == 3)
-    {
-        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::red,      EnemyType::Smart,  topLeft,   1, 0 });
-        enemies.push_back(Enemy{ cols-2, 1, -1,0, Qt::magenta, EnemyType::Smart, topRight,  1, 1 });
-        enemies.push_back(Enemy{ 1, rows-2, 1, 0, Qt::green,  EnemyType::Simple, QRect(),   1, 0 });
-        enemies.push_back(Enemy{ cols-2, rows-2, 0,-1, Qt::blue,  EnemyType::Simple, QRect(),1, 1 });
-        return;
-    }
-
-    // ---------- LEVEL 4 ----------
-    if (currentLevel == 4)
-    {
-        enemies.push_back(Enemy{ 10, 2, 1, 0, Qt::cyan,   EnemyType::Smart,  topLeft, 1, 0 });
-        enemies.push_back(Enemy{ 22, 22, -1,0, Qt::green, EnemyType::Smart, bottomRight, 1, 0 });
-        enemies.push_back(Enemy{ 2, 22, 1, 0, Qt::white,  EnemyType::Smart, bottomLeft, 1, 0 });
-        return;
-    }
+    simThread = new QThread(this);
+    simThread->setObjectName("simulation");
+    sim = new GameSimulation;
+    // Faster ticks for bots; the rules advance per tick, not per second
+    if (int hz = qEnvironmentVariableIntValue("PACMAN_TICK_HZ"))
+        sim->setTickRate(hz);
+    // Chunk memory of a streamed mega maze
+    if (int mb = qEnvironmentVariableIntValue("PACMAN_WORLD_MB"))
+        sim->setWorldMemoryCap(qint64(mb) << 20);
+    sim->moveToThread(simThread);
+    connect(simThread, &QThread::finished, sim, &QObject::deleteLater);
+
+    renderThread = new RenderThread(sim->snapshots(), this);
+    renderThread->setViewport(QSize(cols, rows) * cellSize, kMinCellSize);
+    // Big levels draw their walls once; later launches map the result
+    renderThread->renderer().setLevelCache(LevelLibrary::global().cache());
+    connect(sim, &GameSimulation::snapshotPublished,
+            renderThread, &RenderThread::wake, Qt::DirectConnection);
+
+    // Next level's walls get drawn while this one is still being played
+    connect(sim, &GameSimulation::levelPreloaded, renderThread,
+            [rt = renderThread](int, const BitGrid &walls) { rt->prepareWalls(walls); },
+            Qt::DirectConnection);
+
+    // Back on the GUI thread: HUD and the end-of-level overlay
+    connect(sim, &GameSimulation::statsChanged, this, [this](int s, int l, int lvl) {
+        score = s;
+        lives = l;
+        currentLevel = lvl;
+        updateHUD();
+    });
+    connect(sim, &GameSimulation::gameOver, this, [this]() {
+        flashWalls(Qt::darkRed, 3);
+        QTimer::singleShot(300, this, [this](){
+            handleGameOver();
+        });
+    });
+    connect(sim, &GameSimulation::levelCleared, this, [this]() {
+        QTimer::singleShot(400, this, [this](){
+            handleWin();
+        });
+    });
+    connect(sim, &GameSimulation::levelStarted, this, [this]() {
+        if (!transitionOverlay || !transitionOverlay->isVisible() || !frameScheduler->isActive())
+            return;
+        hideTransition();
+        frame->setFocus();
+    });
+    connect(sim, &GameSimulation::levelFailed, this, [this](const QString &reason) {
+        stopGame();
+        showTransition("Mega Maze", QString("⚠️ %1").arg(reason),
+                       "Menu", [this]() { showLevelSelect(); });
+    });
 }
 
-void drawBlock(QImage &img, int gx, int gy, int cellSize, QColor color)
+// The GUI thread's whole job during play: show the newest finished frame
+void MainWindow::presentLatest()
 {
-    for(int py = gy * cellSize; py < (gy+1)*cellSize; py++)
-        for(int px = gx * cellSize; px < (gx+1)*cellSize; px++)
-            img.setPixel(px, py, color.rgb());
+    if (renderThread->frames().update())
+        presentFrame(renderThread->frames().read());
 }
 
-// --- A* helpers ---
-bool MainWindow::isWalkable(int x, int y) const {
-    if (x < 0 || y < 0 || x >= cols || y >= rows) return false;
-    return maze[y][x] == 0;
-}
-
-// Compute next step towards (tx,ty) from (sx,sy) using A* with 4-neighbour moves.
-bool MainWindow::aStarNextStep(int sx, int sy, int tx, int ty, int &nx, int &ny) {
-    if (sx == tx && sy == ty) return false;
-
-    auto start = qMakePair(sx, sy);
-    auto goal  = qMakePair(tx, ty);
-
-    struct Node { QPair<int,int> p; int f; int g; };
-
-    auto heuristic = [&](const QPair<int,int> &a, const QPair<int,int> &b)->int {
-        return std::abs(a.first - b.first) + std::abs(a.second - b.second);
-    };
-
-    auto cmp = [](const Node &a, const Node &b){
-        if (a.f != b.f) return a.f > b.f;
-        return a.g > b.g;
-    };
-    std::priority_queue<Node, std::vector<Node>, decltype(cmp)> open(cmp);
-
-    QSet<QPair<int,int>> openSet;
-    QSet<QPair<int,int>> closedSet;
-    QMap<QPair<int,int>, QPair<int,int>> cameFrom;
-    QMap<QPair<int,int>, int> gScore;
-
-    gScore[start] = 0;
-    open.push({start, heuristic(start, goal), 0});
-    openSet.insert(start);
-
-    auto pushNeighbor = [&](const QPair<int,int> &current, int nx_, int ny_) {
-        QPair<int,int> np(nx_, ny_);
-        if (!isWalkable(nx_, ny_) || closedSet.contains(np)) return;
-
-        int tentative_g = gScore[current] + 1;
-        if (!gScore.contains(np)) gScore[np] = std::numeric_limits<int>::max();
-        if (tentative_g < gScore[np]) {
-            cameFrom[np] = current;
-            gScore[np] = tentative_g;
-            int f = tentative_g + heuristic(np, goal);
-            open.push({np, f, tentative_g});
-            openSet.insert(np);
-        }
-    };
-
-    while(!open.empty()) {
-        Node cur = open.top(); open.pop();
-        QPair<int,int> current = cur.p;
-        if (closedSet.contains(current)) continue;
-        closedSet.insert(current);
-        openSet.remove(current);
-
-        if (current == goal) {
-            QPair<int,int> step = current;
-            while (cameFrom.contains(step) && cameFrom[step] != start) {
-                step = cameFrom[step];
-            }
-            if (cameFrom.contains(step) || step == goal) {
-                nx = step.first; ny = step.second;
-                return true;
-            } else return false;
-        }
-
-        int cx = current.first, cy = current.second;
-        pushNeighbor(current, cx+1, cy);
-        pushNeighbor(current, cx-1, cy);
-        pushNeighbor(current, cx, cy+1);
-        pushNeighbor(current, cx, cy-1);
-    }
-
-    return false;
-}
-
-void MainWindow::moveEnemies()
+void MainWindow::presentFrame(const QImage &img)
 {
-    QPoint playerPt(playerX, playerY);
-
-    for (auto &e : enemies) {
-        if (e.cooldown > 0) {
-            e.cooldown--;
-            continue;
-        }
-        e.cooldown = e.moveInterval;
-
-        if (e.type == EnemyType::Smart) {
-            bool playerInHabitat = e.habitat.contains(playerPt);
-            if (playerInHabitat) {
-                int nx = e.x, ny = e.y;
-                bool hasStep = aStarNextStep(e.x, e.y, playerX, playerY, nx, ny);
-                if (hasStep) {
-                    e.dx = nx - e.x;
-                    e.dy = ny - e.y;
-                    e.x = nx;
-                    e.y = ny;
-                    continue;
-                }
-            }
-            int tryx = e.x + e.dx;
-            int tryy = e.y + e.dy;
-            if (isWalkable(tryx, tryy)) {
-                e.x = tryx; e.y = tryy;
-            } else {
-                if (e.dx != 0) e.dx = -e.dx;
-                else if (e.dy != 0) e.dy = -e.dy;
-            }
-        } else {
-            int tryx = e.x + e.dx;
-            int tryy = e.y + e.dy;
-            if (isWalkable(tryx, tryy)) {
-                e.x = tryx; e.y = tryy;
-            } else {
-                if (e.dx != 0) e.dx = -e.dx;
-                if (e.dy != 0) e.dy = -e.dy;
-            }
-        }
-    }
+    QPixmap pm = QPixmap::fromImage(img);
+    pm.setDevicePixelRatio(frameDpr);
+    frame->setPixmap(pm);
 }
 
-void MainWindow::checkCollisions()
+// The render thread picks the largest whole device-pixel cell that fits
+// the board into the frame. Tiles are cached per cell size in the
+// renderer, so a resize only costs one render.
+void MainWindow::updateRenderScale()
 {
-    // inside MainWindow::checkCollisions()
-    auto cur = qMakePair(playerX, playerY);
-    if (food.contains(cur)) {
-        food.remove(cur);
-        score += 10;
-        updateHUD();
-        sfxEat->play();    // 🔊 PLAY EAT SOUND
-    }
-
-
-
-
-    for (auto &e : enemies)
-        if (e.x == playerX && e.y == playerY) {
-            // Reset on collision
-            playerX = 1; playerY = 1;
-            initEnemies();
-
-            // Life handling (no audio)
-            lives -= 1;
-            updateHUD();
-
-            if (lives <= 0) {
-                if (gameTimer->isActive()) gameTimer->stop();
-                bgMusic->stop();    // ⛔ Stop background music
-                sfxDeath->play();   // 🔊 Play death sound
-
-                QTimer::singleShot(300, this, [this](){
-                    handleGameOver();
-                });
-            }
-
+    const qreal dpr = frame->devicePixelRatio();
+    const QSize view(int(frame->width() * dpr), int(frame->height() * dpr));
+    if (view == viewPixels && qFuzzyCompare(dpr, frameDpr))
+        return;
 
-            break;
-        }
+    viewPixels = view;
+    frameDpr = dpr;
+    renderThread->setViewport(view, qRound(kMinCellSize * dpr));
 }
 
-void MainWindow::updateFrame()
+// Palette swap only – the retained indexed frame is re-expanded, not redrawn
+void MainWindow::flashWalls(const QColor &color, int times)
 {
-    mouthOpen = !mouthOpen;
-
-    // If a direction is set, attempt to move the player this tick.
-    if (!(playerDirX == 0 && playerDirY == 0)) {
-        int nx = playerX + playerDirX;
-        int ny = playerY + playerDirY;
-        if (isWalkable(nx, ny)) {
-            playerX = nx;
-            playerY = ny;
-
-            // Eat food immediately and update score/HUD
-            auto cur = qMakePair(playerX, playerY);
-            if (food.contains(cur)) {
-                food.remove(cur);
-                score += 10;
-                updateHUD();
-                sfxEat->play();    // 🔊 PLAY EAT SOUND
-            }
-
-        }
-    }
-
-    // Move enemies and check collisions every tick regardless of player movement
-    moveEnemies();
-    checkCollisions();
-
-
-    if (food.isEmpty()) {
-        if (gameTimer->isActive()) gameTimer->stop();
-        bgMusic->stop();
-        sfxWin->play(); // win sound
-
-        QTimer::singleShot(400, this, [this](){
-            handleWin();
+    const QColor normal = renderThread->paletteColor(FrameRenderer::SlotWall);
+    for (int i = 0; i < times * 2; ++i) {
+        QTimer::singleShot(i * 50, this, [this, i, color, normal]() {
+            renderThread->setPaletteColor(FrameRenderer::SlotWall, (i % 2 == 0) ? color : normal);
         });
-        return;
     }
-
-
-    // --- draw the whole scene (maze, food, enemies, player, etc.) ---
-    QImage img(frame->width(), frame->height(), QImage::Format_RGB32);
-    img.fill(Qt::black);
-
-    // MAZE
-    for (int y = 0; y < rows; ++y)
-        for (int x = 0; x < cols; ++x)
-            if (maze[y][x] == 1)
-                drawBlock(img, x, y, cellSize, Qt::darkBlue);
-
-    // FOOD dots
-    for (const auto &f : food) {
-        int gx = f.first, gy = f.second;
-        int dot = cellSize / 4;
-        int sx = gx * cellSize + (cellSize - dot) / 2;
-        int sy = gy * cellSize + (cellSize - dot) / 2;
-        for (int py = sy; py < sy + dot; ++py)
-            for (int px = sx; px < sx + dot; ++px)
-                img.setPixel(px, py, QColor(Qt::white).rgb());
-    }
-
-    // ENEMIES
-    for (const auto &e : enemies)
-        drawBlock(img, e.x, e.y, cellSize, e.color);
-
-    // PAC-MAN
-    drawBlock(img, playerX, playerY, cellSize, Qt::yellow);
-
-    // mouth wedge...
-    if (mouthOpen) {
-        int px = playerX * cellSize;
-        int py = playerY * cellSize;
-        for (int y = 0; y < cellSize; ++y)
-            for (int x = 0; x < cellSize; ++x) {
-                int rx = px + x, ry = py + y;
-                float dx = x - cellSize / 2.0f;
-                float dy = y - cellSize / 2.0f;
-                float angle = atan2(dy, dx) * 180.0f / M_PI;
-                bool cut = false;
-                if (playerDirX == 1 && angle > -30 && angle < 30) cut = true;
-                if (playerDirX == -1 && (angle > 150 || angle < -150)) cut = true;
-                if (playerDirY == 1 && angle > 60 && angle < 120) cut = true;
-                if (playerDirY == -1 && angle > -120 && angle < -60) cut = true;
-                if (cut) img.setPixel(rx, ry, QColor(Qt::black).rgb());
-            }
-    }
-
-    frame->setPixmap(QPixmap::fromImage(img));
 }
 
 // =========================
@@ -655,71 +284,108 @@ void MainWindow::showLeaderboard()
 
 
 
+// Arrow key -> grid direction
+static bool arrowDirection(int key, qint8 &dx, qint8 &dy)
+{
+    dx = dy = 0;
+    if (key == Qt::Key_Left)       dx = -1;
+    else if (key == Qt::Key_Right) dx = 1;
+    else if (key == Qt::Key_Up)    dy = -1;
+    else if (key == Qt::Key_Down)  dy = 1;
+    else return false;
+    return true;
+}
+
 void MainWindow::keyPressEvent(QKeyEvent *e)
 {
-    if (menuOverlay && menuOverlay->isVisible()) { e->ignore(); return; }
+    if (overlayVisible()) { e->ignore(); return; }
 
-    // set direction when key pressed (do NOT move immediately here)
-    if (e->key() == Qt::Key_Left)  { playerDirX = -1; playerDirY = 0; }
-    if (e->key() == Qt::Key_Right) { playerDirX = 1;  playerDirY = 0; }
-    if (e->key() == Qt::Key_Up)    { playerDirX = 0;  playerDirY = -1; }
-    if (e->key() == Qt::Key_Down)  { playerDirX = 0;  playerDirY = 1; }
+    // queue the direction for the next tick (do NOT move immediately here);
+    // auto-repeat adds nothing, the key is still held
+    qint8 dx, dy;
+    if (arrowDirection(e->key(), dx, dy) && !e->isAutoRepeat())
+        sim->postInput({ InputEvent::Press, dx, dy, monotonicNs() });
 }
 
 void MainWindow::keyReleaseEvent(QKeyEvent *e)
 {
-    if (menuOverlay && menuOverlay->isVisible()) { e->ignore(); return; }
-
-    if (e->key() == Qt::Key_Left ||
-        e->key() == Qt::Key_Right ||
-        e->key() == Qt::Key_Up ||
-        e->key() == Qt::Key_Down)
-    {
-        // stop immediately when the arrow key is released
-        playerDirX = 0;
-        playerDirY = 0;
-    }
+    if (overlayVisible()) { e->ignore(); return; }
+
+    qint8 dx, dy;
+    if (arrowDirection(e->key(), dx, dy) && !e->isAutoRepeat())
+        sim->postInput({ InputEvent::Release, dx, dy, monotonicNs() });
 }
 
 
-void MainWindow::initAudio()
+void MainWindow::initAssets()
 {
-    // ----- Background Music -----
-    bgMusic = new QMediaPlayer(this);
-    bgOutput = new QAudioOutput(this);
-    bgMusic->setAudioOutput(bgOutput);
-
-    // Set your music file (MP3/WAV/OGG)
-    bgMusic->setSource(QUrl("qrc:/sounds/bgm.mp3"));
-    bgOutput->setVolume(0.4);
-
-    // Loop forever
-    connect(bgMusic, &QMediaPlayer::mediaStatusChanged, this, [&](QMediaPlayer::MediaStatus status){
-        if (status == QMediaPlayer::EndOfMedia)
-            bgMusic->play();
-    });
+    QElapsedTimer t;
+    t.start();
+    if (!assets.open(AssetArchive::defaultPath())) {
+        qDebug() << "assets: no usable" << AssetArchive::defaultPath()
+                 << "- rasterizing and synthesizing at runtime";
+        return;
+    }
 
-    bgMusic->play();
+    const AssetView font = assets.find(AssetIds::FontRetro);
+    if (font.isValid() && font.type == AssetType::Font)
+        retroFontId = QFontDatabase::addApplicationFontFromData(
+            QByteArray::fromRawData(reinterpret_cast<const char *>(font.data), font.size));
 
+    renderThread->renderer().setAssets(&assets);
+    qCDebug(lcPerf) << "assets: mapped" << assets.mappedBytes() / 1024 << "KB in"
+                    << t.nsecsElapsed() / 1e6 << "ms";
+}
 
-    // ----- Eat Pellet -----
-    sfxEat = new QSoundEffect(this);
-    sfxEat->setSource(QUrl("qrc:/sounds/eat.wav"));
-    sfxEat->setVolume(0.65);
+void MainWindow::initAudio()
+{
+    // Device probing and sound synthesis happen off the GUI thread, so the
+    // window comes up without waiting on the audio backend. Effects played
+    // before the mixer is ready are simply dropped.
+    audioThread = new QThread(this);
+    audioThread->setObjectName("audio");
+
+    mixer = new AudioMixer;
+    mixer->setMusicVolume(0.4f);
+    mixer->setMusicPlaying(true);
+    mixer->moveToThread(audioThread);
+    sim->setMixer(mixer);   // play() is thread safe, the simulation calls it directly
+    connect(audioThread, &QThread::finished, mixer, &QObject::deleteLater);
+    audioThread->start();
+
+    QMetaObject::invokeMethod(mixer, [m = mixer, a = &assets]() {
+        m->initialize();
+
+        // ----- Effects: baked PCM from the archive, else synthesized -----
+        struct { AudioMixer::Sound sound; quint32 id; const ChipSong &song; } sfx[] = {
+            { AudioMixer::Eat, AssetIds::SfxEat, ChipSongs::eat() },
+            { AudioMixer::Death, AssetIds::SfxDeath, ChipSongs::death() },
+            { AudioMixer::Win, AssetIds::SfxWin, ChipSongs::win() },
+        };
+        QElapsedTimer t;
+        t.start();
+        int baked = 0;
+        for (const auto &s : sfx) {
+            const AssetView pcm = a->find(assetVariant(s.id, quint32(m->sampleRate())));
+            if (pcm.isValid() && pcm.type == AssetType::Pcm16Mono
+                && pcm.param0 == quint32(m->sampleRate())) {
+                m->loadPcm(s.sound, reinterpret_cast<const qint16 *>(pcm.data),
+                           int(pcm.size / sizeof(qint16)));
+                ++baked;
+            } else {
+                m->loadSong(s.sound, s.song);
+            }
+        }
+        qCDebug(lcPerf) << "audio: effects ready in" << t.nsecsElapsed() / 1e6 << "ms,"
+                        << baked << "of" << int(std::size(sfx)) << "from the archive";
 
-    // ----- Death -----
-    sfxDeath = new QSoundEffect(this);
-    sfxDeath->setSource(QUrl("qrc:/sounds/death.wav"));
-    sfxDeath->setVolume(0.9);
+        m->setMusic(&ChipSongs::theme());   // loops forever, rendered live
 
-    // ----- Win -----
-    sfxWin = new QSoundEffect(this);
-    sfxWin->setSource(QUrl("qrc:/sounds/win.wav"));
-    sfxWin->setVolume(0.9);
+        if (!m->startOutput())
+            qDebug() << "audio: no usable output device, sound muted";
+    });
 }
 
-
-
 // // ----- LIVES RENDER -----
 // void MainWindow::drawLives(QImage &img) {
 //     // Bottom-left, 3 red squares (grey if lost)
@@ -738,14 +404,32 @@ void MainWindow::initAudio()
 
 // ----- GAME FLOW -----
 void MainWindow::startGame(int level) {
-    if (levels.isEmpty()) setupLevels();
-
+    megaSide = 0;
     currentLevel = level;
-    initMaze(currentLevel);
-    initFood();
-    initEnemies();
-    bgMusic->play();
+    launch([s = sim, level]() { s->startLevel(level); });
+}
+
+// PACMAN_MEGA_SIDE picks another size, e.g. for a quicker first load
+void MainWindow::startMegaMaze() {
+    megaSide = kMegaMazeSide;
+    if (int side = qEnvironmentVariableIntValue("PACMAN_MEGA_SIDE"))
+        megaSide = qBound(25, side, LevelPack::kMaxSide);
+    currentLevel = 1;
+    launch([s = sim, side = megaSide]() { s->startMegaMaze(side); });
 
+    // Up until the simulation says the board is in, which the first time
+    // takes a few seconds of generating and writing
+    showTransition("Mega Maze", QString("🧩 Building the %1x%1 board...").arg(megaSide),
+                   "Cancel", [this]() { showLevelSelect(); });
+}
+
+void MainWindow::launch(const std::function<void()> &begin) {
+    // Per-level wall theme, applied through the renderer palette
+    static const Qt::GlobalColor wallThemes[] = {
+        Qt::darkBlue, Qt::darkMagenta, Qt::darkCyan, Qt::darkGreen
+    };
+    renderThread->setPaletteColor(FrameRenderer::SlotWall,
+                                  wallThemes[qMax(0, currentLevel - 1) % 4]);
 
     lives = 3;
 
@@ -762,13 +446,16 @@ void MainWindow::startGame(int level) {
     currentPlayerName = playerName;
 
 
-    mouthOpen = 0;
     updateHUD();  // ✅ show correct Level/Lives/Score immediately
 
-    if (!gameTimer->isActive()) gameTimer->start(120);
+    QMetaObject::invokeMethod(sim, begin);
+    frameScheduler->resetStats();
+    renderThread->resetStats();
+    frameScheduler->start();
 
-    // hide overlay if visible
+    // hide overlays if visible
     if (menuOverlay) menuOverlay->hide();
+    hideTransition();
 
     // make sure game receives key events
     this->setFocus();
@@ -780,29 +467,48 @@ void MainWindow::startGame(int level) {
 }
 
 void MainWindow::stopGame() {
-    if (gameTimer->isActive()) gameTimer->stop();
+    QMetaObject::invokeMethod(sim, &GameSimulation::stop);
+    if (!frameScheduler->isActive())
+        return;
+    frameScheduler->stop();
+    if (!lcPerf().isDebugEnabled())
+        return;
+    qCDebug(lcPerf) << "frame interval:" << frameScheduler->frameIntervals().summary();
+    qCDebug(lcPerf) << "present time:" << frameScheduler->renderTimes().summary()
+                    << "janks:" << frameScheduler->jankCount();
+    qCDebug(lcPerf) << "render time:" << renderThread->renderTimes().summary();
+    qCDebug(lcPerf) << "input to motion:" << sim->inputLatencyStats().summary();
+    const GameSimulation::TickStats ticks = sim->tickStats();
+    qCDebug(lcPerf) << "tick duration:" << ticks.duration.summary();
+    qCDebug(lcPerf) << "enemy AI per tick:" << ticks.ai.summary();
+    qCDebug(lcPerf) << "tick lateness:" << ticks.lateness.summary()
+                    << "dropped:" << ticks.dropped << "of" << ticks.ticks + ticks.dropped;
+    qCDebug(lcPerf) << "sfx latency:" << mixer->latencyStats().summary();
+    qCDebug(lcPerf) << "mix cost per buffer:" << mixer->mixCostStats().summary();
 }
 
 void MainWindow::ensureMenuOverlay() {
     if (menuOverlay) return;
 
+    // One scoped stylesheet, parsed once; the retro widgets paint themselves
     menuOverlay = new QWidget(this);
-    menuOverlay->setStyleSheet("background: rgba(0,0,0,0.65);");
+    menuOverlay->setObjectName("menuOverlay");
+    menuOverlay->setStyleSheet(
+        "#menuOverlay { background: rgba(0,0,0,0.65); }"
+        "#menuPanel { background: #111; border: 2px solid #444; border-radius: 10px; }");
 
     auto container = new QWidget(menuOverlay);
-    container->setStyleSheet("background: #111; border: 2px solid #444; border-radius: 10px;");
+    container->setObjectName("menuPanel");
 
     auto v = new QVBoxLayout(container);
-    auto title = new QLabel("Select Level", container);
-    title->setAlignment(Qt::AlignCenter);
-    title->setStyleSheet("color: white; font-size: 22px; margin: 8px 0;");
+    auto title = new RetroLabel("Select Level", container);
     v->addWidget(title);
 
     auto grid = new QGridLayout();
-    btnLvl1 = new QPushButton("Level 1", container);
-    btnLvl2 = new QPushButton("Level 2", container);
-    btnLvl3 = new QPushButton("Level 3", container);
-    btnLvl4 = new QPushButton("Level 4", container);
+    btnLvl1 = new RetroButton("Level 1", container);
+    btnLvl2 = new RetroButton("Level 2", container);
+    btnLvl3 = new RetroButton("Level 3", container);
+    btnLvl4 = new RetroButton("Level 4", container);
     btnLvl1->setMinimumHeight(40);
     btnLvl2->setMinimumHeight(40);
     btnLvl3->setMinimumHeight(40);
@@ -811,13 +517,16 @@ void MainWindow::ensureMenuOverlay() {
     grid->addWidget(btnLvl2, 0, 1);
     grid->addWidget(btnLvl3, 1, 0);
     grid->addWidget(btnLvl4, 1, 1);
+    btnMega = new RetroButton("Mega Maze", container);
+    btnMega->setMinimumHeight(40);
+    grid->addWidget(btnMega, 2, 0, 1, 2);
     v->addLayout(grid);
 
-    btnMenuExit = new QPushButton("Exit", container);
+    btnMenuExit = new RetroButton("Exit", container);
     btnMenuExit->setMinimumHeight(36);
     v->addWidget(btnMenuExit);
 
-    QPushButton *btnLeaderboard = new QPushButton("Leaderboard", container);
+    QPushButton *btnLeaderboard = new RetroButton("Leaderboard", container);
     btnLeaderboard->setMinimumHeight(36);
     v->addWidget(btnLeaderboard);
 
@@ -839,6 +548,7 @@ void MainWindow::ensureMenuOverlay() {
     connect(btnLvl2, &QPushButton::clicked, this, [this](){ startGame(2); });
     connect(btnLvl3, &QPushButton::clicked, this, [this](){ startGame(3); });
     connect(btnLvl4, &QPushButton::clicked, this, [this](){ startGame(4); });
+    connect(btnMega, &QPushButton::clicked, this, [this](){ startMegaMaze(); });
     connect(btnMenuExit, &QPushButton::clicked, this, [this](){ close(); });
 
     // overlay shouldn’t take focus away forever
@@ -846,192 +556,149 @@ void MainWindow::ensureMenuOverlay() {
     btnLvl2->setFocusPolicy(Qt::StrongFocus);
     btnLvl3->setFocusPolicy(Qt::StrongFocus);
     btnLvl4->setFocusPolicy(Qt::StrongFocus);
+    btnMega->setFocusPolicy(Qt::StrongFocus);
 
     positionOverlay();
     menuOverlay->hide();
 }
 
-void MainWindow::positionOverlay() {
-    if (!menuOverlay) return;
-    // Cover the frame area (center widget)
-    const QPoint topLeft = frame->mapTo(this, QPoint(0,0));
-    menuOverlay->setGeometry(QRect(topLeft, frame->size()));
-    menuOverlay->raise();
-}
+// Same look as the menu, but only ever one or two buttons
+void MainWindow::ensureTransitionOverlay() {
+    if (transitionOverlay) return;
+
+    transitionOverlay = new QWidget(this);
+    transitionOverlay->setObjectName("transitionOverlay");
+    transitionOverlay->setStyleSheet(
+        "#transitionOverlay { background: rgba(0,0,0,0.55); }"
+        "#transitionPanel { background: #111; border: 2px solid #444; border-radius: 10px; }"
+        "#transitionText { color: #ddd; }");
+
+    auto panel = new QWidget(transitionOverlay);
+    panel->setObjectName("transitionPanel");
+
+    auto v = new QVBoxLayout(panel);
+    transitionTitle = new RetroLabel(QString(), panel);
+    v->addWidget(transitionTitle);
+    transitionText = new QLabel(panel);
+    transitionText->setObjectName("transitionText");
+    transitionText->setFont(retroFont(10));
+    transitionText->setAlignment(Qt::AlignCenter);
+    v->addWidget(transitionText);
+
+    auto row = new QHBoxLayout();
+    btnTransitionNext = new RetroButton(QString(), panel);
+    btnTransitionBack = new RetroButton(QString(), panel);
+    btnTransitionNext->setMinimumHeight(36);
+    btnTransitionBack->setMinimumHeight(36);
+    btnTransitionNext->setFocusPolicy(Qt::StrongFocus);
+    btnTransitionBack->setFocusPolicy(Qt::StrongFocus);
+    row->addWidget(btnTransitionNext);
+    row->addWidget(btnTransitionBack);
+    v->addLayout(row);
+
+    auto outer = new QVBoxLayout(transitionOverlay);
+    outer->addStretch();
+    outer->addWidget(panel, 0, Qt::AlignHCenter);
+    outer->addStretch();
 
-void MainWindow::showLevelSelect() {
-    stopGame();           // stop timer when showing menu
-    ensureMenuOverlay();
-    positionOverlay();
-    menuOverlay->show();
-    menuOverlay->raise();
-}
+    // The actions change per transition; take a copy before hiding
+    connect(btnTransitionNext, &QPushButton::clicked, this, [this]() {
+        const auto next = onTransitionNext;
+        hideTransition();
+        if (next) next();
+    });
+    connect(btnTransitionBack, &QPushButton::clicked, this, [this]() {
+        const auto back = onTransitionBack;
+        hideTransition();
+        if (back) back();
+    });
 
-void MainWindow::resizeEvent(QResizeEvent *event) {
-    // keep exit button pinned to top-right of MainWindow
-    exitBtn->move(width() - exitBtn->width() - 1, 1);
     positionOverlay();
-    QMainWindow::resizeEvent(event);
+    transitionOverlay->hide();
 }
 
-// =====================
-// 🎨 RETRO UI IMPLEMENTATION
-// =====================
-
-// ----- RetroLabel -----
-RetroLabel::RetroLabel(const QString &text, QWidget *parent)
-    : QLabel(text, parent), bright(true)
+void MainWindow::showTransition(const QString &title, const QString &text,
+                                const QString &nextLabel, std::function<void()> next,
+                                const QString &backLabel, std::function<void()> back)
 {
-    setAlignment(Qt::AlignCenter);
-    setStyleSheet(R"(
-        color: #FFFFFF;
-        font-family: 'Press Start 2P', monospace;
-        font-size: 18px;
-        font-weight: bold;
-        letter-spacing: 1px;
-        background-color: #222222;
-        border: 3px solid #555555;
-        border-radius: 6px;
-        padding: 8px 16px;
-        box-shadow: 2px 2px 0 #000000;
-    )");
-
-    blinkTimer = new QTimer(this);
-    connect(blinkTimer, &QTimer::timeout, this, &RetroLabel::toggleGlow);
-    blinkTimer->start(600);
-}
+    ensureTransitionOverlay();
+    transitionTitle->setText(title);
+    transitionText->setText(text);
+    btnTransitionNext->setText(nextLabel);
+    btnTransitionBack->setText(backLabel);
+    btnTransitionBack->setVisible(!backLabel.isEmpty());
+    onTransitionNext = std::move(next);
+    onTransitionBack = std::move(back);
 
-void RetroLabel::toggleGlow()
-{
-    bright = !bright;
-    if (bright)
-        setStyleSheet(R"(
-            color: #FFFFFF;
-            font-family: 'Press Start 2P', monospace;
-            font-size: 18px;
-            font-weight: bold;
-            letter-spacing: 1px;
-            background-color: #222222;
-            border: 3px solid #777777;
-            border-radius: 6px;
-            padding: 8px 16px;
-            box-shadow: 2px 2px 0 #000000;
-        )");
-    else
-        setStyleSheet(R"(
-            color: #CCCCCC;
-            font-family: 'Press Start 2P', monospace;
-            font-size: 18px;
-            font-weight: bold;
-            letter-spacing: 1px;
-            background-color: #1C1C1C;
-            border: 3px solid #555555;
-            border-radius: 6px;
-            padding: 8px 16px;
-            box-shadow: 2px 2px 0 #000000;
-        )");
+    positionOverlay();
+    transitionOverlay->show();
+    transitionOverlay->raise();
+    btnTransitionNext->setFocus();
 }
 
-
-
-// ----- GameHUD -----
-// ----- GameHUD -----
-GameHUD::GameHUD(QWidget *parent) : QWidget(parent)
-{
-    auto layout = new QHBoxLayout(this);
-    layout->setContentsMargins(20, 10, 20, 10);
-    layout->setSpacing(30);
-
-    // Create labels
-    scoreLabel = new QLabel("SCORE: 0000", this);
-    livesLabel = new QLabel("LIVES: ❤❤❤", this);  // ❤️ default lives displayed
-    levelLabel = new QLabel("LEVEL: 1", this);
-
-    // Apply consistent Minecraft-like styling
-    updateStyle(scoreLabel, "yellow");
-    updateStyle(livesLabel, "red");
-    updateStyle(levelLabel, "dodgerblue");
-
-    layout->addWidget(scoreLabel);
-    layout->addWidget(livesLabel);
-    layout->addWidget(levelLabel);
-    layout->addStretch(1);
-
-    setLayout(layout);
-    setStyleSheet(R"(
-        background-color: #2E2E2E;
-        border-bottom: 4px solid #555555;
-    )");
+void MainWindow::hideTransition() {
+    if (transitionOverlay) transitionOverlay->hide();
+    onTransitionNext = nullptr;
+    onTransitionBack = nullptr;
 }
 
-// Apply style individually for color customization
-void GameHUD::updateStyle(QLabel *lbl, const QString &colorName)
-{
-    lbl->setStyleSheet(QString(R"(
-        color: %1;
-        font-family: 'Press Start 2P', monospace;
-        font-size: 18px;
-        font-weight: bold;
-        background-color: #3A3A3A;
-        border: 2px solid #5A5A5A;
-        border-radius: 6px;
-        padding: 10px 16px;
-        margin: 4px;
-    )").arg(colorName));
+bool MainWindow::overlayVisible() const {
+    return (menuOverlay && menuOverlay->isVisible())
+        || (transitionOverlay && transitionOverlay->isVisible());
 }
 
-// Update values dynamically
-void GameHUD::setScore(int value)
-{
-    scoreLabel->setText(QString("SCORE: %1").arg(value, 4, 10, QLatin1Char('0')));
+void MainWindow::positionOverlay() {
+    if (!menuOverlay && !transitionOverlay) return;
+    // Cover the frame area (center widget)
+    const QRect area(frame->mapTo(this, QPoint(0,0)), frame->size());
+    for (QWidget *overlay : { menuOverlay, transitionOverlay }) {
+        if (!overlay) continue;
+        overlay->setGeometry(area);
+        overlay->raise();
+    }
 }
 
-void GameHUD::setLives(int value)
-{
-    // Build hearts string dynamically
-    QString hearts;
-    for (int i = 0; i < value; ++i)
-        hearts += "❤ ";
-    if (value <= 0) hearts = "💀";
-
-    livesLabel->setText(QString("LIVES: %1").arg(hearts.trimmed()));
+void MainWindow::showLevelSelect() {
+    stopGame();           // stop timer when showing menu
+    hideTransition();
+    ensureMenuOverlay();
+    positionOverlay();
+    menuOverlay->show();
+    menuOverlay->raise();
 }
 
-void GameHUD::setLevel(int value)
-{
-    levelLabel->setText(QString("LEVEL: %1").arg(value));
+void MainWindow::resizeEvent(QResizeEvent *event) {
+    // keep exit button pinned to top-right of MainWindow
+    exitBtn->move(width() - exitBtn->width() - 1, 1);
+    positionOverlay();
+    QMainWindow::resizeEvent(event);
 }
 
+// Both end states leave the last frame up under a non-modal overlay; the
+// simulation has already preloaded the next level by now
 void MainWindow::handleWin()
 {
     stopGame();
     saveScore(currentPlayerName, score);
 
-
-    QMessageBox msg(this);
-    msg.setWindowTitle("Level Cleared!");
-    msg.setText(QString("🎉 You cleared Level %1!\nYour score: %2")
-                    .arg(currentLevel)
-                    .arg(score));
-    msg.setIcon(QMessageBox::Information);
-    msg.addButton("Next Level", QMessageBox::AcceptRole);
-    msg.addButton("Quit", QMessageBox::RejectRole);
-
-    int ret = msg.exec();
-
-    if (ret == 0) {
-        currentLevel++;
-        if (currentLevel > levels.size()) {
-            QMessageBox::information(this, "Victory!",
-                                     "🏆 You cleared all levels! Game Complete!");
-            showLevelSelect();
-        } else {
-            startGame(currentLevel);
-        }
+    if (megaSide > 0) {
+        showTransition("Victory!",
+                       QString("🏆 You cleared the %1x%1 mega maze!\nFinal score: %2").arg(megaSide).arg(score),
+                       "Menu", [this]() { showLevelSelect(); });
+        return;
     }
-    else {
-        showLevelSelect();
+
+    if (currentLevel >= sim->levelCount()) {
+        showTransition("Victory!",
+                       QString("🏆 You cleared all levels! Game Complete!\nFinal score: %1").arg(score),
+                       "Menu", [this]() { showLevelSelect(); });
+        return;
     }
+
+    showTransition("Level Cleared!",
+                   QString("🎉 You cleared Level %1!\nYour score: %2").arg(currentLevel).arg(score),
+                   "Next Level", [this]() { startGame(currentLevel + 1); },
+                   "Quit", [this]() { showLevelSelect(); });
 }
 
 void MainWindow::handleGameOver()
@@ -1039,23 +706,11 @@ void MainWindow::handleGameOver()
     stopGame();
     saveScore(currentPlayerName, score);
 
-    QMessageBox msg(this);
-    msg.setWindowTitle("Game Over");
-    msg.setText(QString("💀 You lost all lives!\nFinal score: %1").arg(score));
-    msg.setIcon(QMessageBox::Critical);
-    msg.addButton("Retry Level", QMessageBox::AcceptRole);
-    msg.addButton("Quit to Menu", QMessageBox::RejectRole);
-
-    int ret = msg.exec();
-
-    if (ret == 0) {
-        startGame(currentLevel);
-    } else {
-        showLevelSelect();
-    }
+    showTransition("Game Over",
+                   QString("💀 You lost all lives!\nFinal score: %1").arg(score),
+                   "Retry Level", [this]() {
+                       if (megaSide > 0) startMegaMaze();
+                       else startGame(currentLevel);
+                   },
+                   "Quit to Menu", [this]() { showLevelSelect(); });
 }
-
-
-
-
-
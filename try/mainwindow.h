@@ -22,83 +22,20 @@
 #include <QFile>
 #include <QTextStream>
 #include <QInputDialog>
-
-// ---- Qt 6 Multimedia ----
-#include <QtMultimedia/QMediaPlayer>
-#include <QtMultimedia/QAudioOutput>
-#include <QtMultimedia/QSoundEffect>
+#include <QThread>
+#include <functional>
 
 #include "my_label.h"
-
-// ==============================
-// 🎨 MINECRAFT-STYLE UI CLASSES
-// ==============================
-
-class RetroLabel : public QLabel
-{
-    Q_OBJECT
-public:
-    explicit RetroLabel(const QString &text, QWidget *parent = nullptr);
-private slots:
-    void toggleGlow();
-private:
-    QTimer *blinkTimer;
-    bool bright;
-};
-
-class GameHUD : public QWidget
-{
-    Q_OBJECT
-public:
-    explicit GameHUD(QWidget *parent = nullptr);
-
-    void setScore(int value);
-    void setLives(int value);
-    void setLevel(int value);
-
-private:
-    QLabel *scoreLabel;
-    QLabel *livesLabel;
-    QLabel *levelLabel;
-
-    void updateStyle(QLabel *label, const QString &colorName);
-};
-
-class CRTOverlay : public QWidget
-{
-    Q_OBJECT
-public:
-    explicit CRTOverlay(QWidget *parent = nullptr)
-    {
-        setAttribute(Qt::WA_TransparentForMouseEvents);
-    }
-
-protected:
-    void paintEvent(QPaintEvent *) override
-    {
-        QPainter p(this);
-        p.setOpacity(0.08);
-        p.setPen(QPen(Qt::black, 1));
-        for (int y = 0; y < height(); y += 3)
-            p.drawLine(0, y, width(), y);
-    }
-};
-
-// ==============================
-// 🕹 GAME LOGIC STRUCTURES
-// ==============================
-
-enum class EnemyType { Simple, Smart };
-
-struct Enemy {
-    int x, y;
-    int dx, dy;
-    QColor color;
-    EnemyType type;
-    QRect habitat;
-    int moveInterval;
-    int cooldown;
-};
+#include "assetpack.h"
+#include "audiomixer.h"
+#include "gamehud.h"
+#include "gametypes.h"
+#include "retrowidgets.h"
+#include "framerenderer.h"
+#include "framescheduler.h"
+#include "gamesimulation.h"
+#include "levellibrary.h"
+#include "renderthread.h"
 
 // ==============================
 // 🧠 MAIN WINDOW
@@ -119,26 +56,34 @@ protected:
 
 private:
 
-    // ---------- GRID / PLAYER ----------
+    // ---------- GRID ----------
+    // Cells never get smaller than this (logical pixels); bigger boards
+    // scroll instead
+    static constexpr int kMinCellSize = 12;
+    static constexpr int kMegaMazeSide = 4096;
+
     MyLabel *frame;
-    int cellSize;
+    int cellSize;           // initial window size only
+    QSize viewPixels;       // frame in device pixels, handed to the renderer
+    qreal frameDpr = 1.0;
     int rows, cols;
-    QVector<QVector<int>> maze;
-    QSet<QPair<int,int>> food;
-    QVector<Enemy> enemies;
-
-    int playerX, playerY;
-    int playerDirX, playerDirY;
-    bool mouthOpen;
+    int currentLevel;
+    int megaSide = 0;       // board side while playing a mega maze
 
-    QSet<int> pressedKeys;
+    // ---------- PIPELINE ----------
+    // GUI thread: input + present. The rules tick on simThread and the
+    // raster runs on renderThread; see GameSimulation and RenderThread.
+    QThread *simThread = nullptr;
+    GameSimulation *sim = nullptr;
+    RenderThread *renderThread = nullptr;
 
-    // ---------- LEVELS ----------
-    QVector<QVector<QPoint>> levels;
-    int currentLevel;
+    // ---------- ASSETS ----------
+    // Mapped for the whole session; tiles, clips and font point into it
+    AssetArchive assets;
+    int retroFontId = -1;
 
-    // ---------- TIMER ----------
-    QTimer *gameTimer;
+    // ---------- PRESENTATION ----------
+    FrameScheduler *frameScheduler;
 
     // ---------- STATS ----------
     int lives;
@@ -148,7 +93,6 @@ private:
 
     // ---------- UI ----------
     GameHUD *hud;
-    CRTOverlay *crtOverlay;
     QPushButton *exitBtn;
 
     QWidget *menuOverlay = nullptr;
@@ -156,17 +100,24 @@ private:
     QPushButton *btnLvl2 = nullptr;
     QPushButton *btnLvl3 = nullptr;
     QPushButton *btnLvl4 = nullptr;
+    QPushButton *btnMega = nullptr;
     QPushButton *btnMenuExit = nullptr;
 
+    // End-of-level overlay; non-modal, the next level is preloaded behind it
+    QWidget *transitionOverlay = nullptr;
+    QLabel *transitionTitle = nullptr;
+    QLabel *transitionText = nullptr;
+    QPushButton *btnTransitionNext = nullptr;
+    QPushButton *btnTransitionBack = nullptr;
+    std::function<void()> onTransitionNext;
+    std::function<void()> onTransitionBack;
+
     // ============================
     // 🎵 AUDIO (Qt6 Multimedia)
     // ============================
-    QMediaPlayer *bgMusic;
-    QAudioOutput *bgOutput;
-
-    QSoundEffect *sfxEat;
-    QSoundEffect *sfxDeath;
-    QSoundEffect *sfxWin;
+    // Mixer (and the synth inside it) runs on its own thread, see initAudio()
+    QThread *audioThread = nullptr;
+    AudioMixer *mixer = nullptr;
 
     // ============================
     // 🏆 LEADERBOARD SYSTEM
@@ -176,26 +127,31 @@ private:
     void showLeaderboard();
 
     // ---------- INIT ----------
-    void setupLevels();
-    void initMaze(int levelNumber);
-    void initFood();
-    void initEnemies();
+    void initAssets();
     void initAudio();
+    void initPipeline();
 
-    // ---------- GAMEPLAY ----------
-    bool isWalkable(int x, int y) const;
-    bool aStarNextStep(int sx, int sy, int tx, int ty, int &nx, int &ny);
-    void moveEnemies();
-    void checkCollisions();
-    void updateFrame();
+    // ---------- PRESENTATION ----------
+    void presentLatest();
+    void presentFrame(const QImage &img);
+    void updateRenderScale();
+    void flashWalls(const QColor &color, int times);
     void drawLives(QImage &img);
 
     // ---------- FLOW ----------
     void startGame(int level);
+    void startMegaMaze();
+    void launch(const std::function<void()> &begin);
     void stopGame();
     void showLevelSelect();
 
     void ensureMenuOverlay();
+    void ensureTransitionOverlay();
+    void showTransition(const QString &title, const QString &text,
+                        const QString &nextLabel, std::function<void()> next,
+                        const QString &backLabel = QString(), std::function<void()> back = nullptr);
+    void hideTransition();
+    bool overlayVisible() const;
     void positionOverlay();
     void updateHUD();
 
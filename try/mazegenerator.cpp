@@ -0,0 +1,519 @@
+#include "mazegenerator.h"
+#include "levelcompiler.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtEndian>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+constexpr int kMinSide = 5;
+
+// Sweep rounds before the flood fill gives up on whole rows
+constexpr int kMaxFillRounds = 16;
+
+const int kDirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+// Kogge-Stone occluded fill: gen spreads along runs of prop, six steps
+// for all 64 bits instead of one step per cell
+inline quint64 fillUp(quint64 gen, quint64 prop)
+{
+    gen |= prop & (gen << 1);   prop &= prop << 1;
+    gen |= prop & (gen << 2);   prop &= prop << 2;
+    gen |= prop & (gen << 4);   prop &= prop << 4;
+    gen |= prop & (gen << 8);   prop &= prop << 8;
+    gen |= prop & (gen << 16);  prop &= prop << 16;
+    gen |= prop & (gen << 32);
+    return gen;
+}
+
+inline quint64 fillDown(quint64 gen, quint64 prop)
+{
+    gen |= prop & (gen >> 1);   prop &= prop >> 1;
+    gen |= prop & (gen >> 2);   prop &= prop >> 2;
+    gen |= prop & (gen >> 4);   prop &= prop >> 4;
+    gen |= prop & (gen >> 8);   prop &= prop >> 8;
+    gen |= prop & (gen >> 16);  prop &= prop >> 16;
+    gen |= prop & (gen >> 32);
+    return gen;
+}
+
+// Scratch for one candidate at a time; one per thread, so nothing is
+// allocated once it has seen the biggest size.
+//
+// Tiles are bits, 64 to a word, each row starting on a fresh word. Maze
+// cells sit on odd tiles and the walls between them on the tiles in
+// between, so carving a passage opens the cell and the wall tile.
+struct Generator
+{
+    struct Room { int x, y, w, h; };    // in cells
+
+    int cols = 0, rows = 0, words = 0;
+    int cw = 0, ch = 0;                 // cells across and down
+    std::vector<quint64> open, reach;
+    std::vector<quint8> visited;        // per cell
+    std::vector<int> roomOf;            // per cell, -1 outside rooms
+    std::vector<Room> rooms;
+    std::vector<int> stack;
+
+    void reset(int c, int r)
+    {
+        cols = c; rows = r;
+        words = (cols + 63) / 64;
+        cw = (cols - 1) / 2;
+        ch = (rows - 1) / 2;
+        open.assign(size_t(words) * rows, 0);
+        reach.resize(open.size());
+        visited.assign(size_t(cw) * ch, 0);
+        roomOf.assign(visited.size(), -1);
+        rooms.clear();
+        stack.clear();
+    }
+
+    quint64 *row(std::vector<quint64> &g, int y) { return g.data() + size_t(y) * words; }
+    const quint64 *row(const std::vector<quint64> &g, int y) const { return g.data() + size_t(y) * words; }
+
+    bool isOpen(int x, int y) const
+    {
+        if (uint(x) >= uint(cols) || uint(y) >= uint(rows)) return false;
+        return (row(open, y)[x >> 6] >> (x & 63)) & 1;
+    }
+    void carve(int x, int y) { row(open, y)[x >> 6] |= quint64(1) << (x & 63); }
+
+    QPoint tileOf(int cell) const { return QPoint(2 * (cell % cw) + 1, 2 * (cell / cw) + 1); }
+
+    int openAround(int x, int y) const
+    {
+        int n = 0;
+        for (const auto &d : kDirs)
+            n += isOpen(x + d[0], y + d[1]);
+        return n;
+    }
+
+    // Entering a room opens all of it at once: every cell is visited and
+    // queued, so the room gets exactly one door from the tree
+    void visit(int cell, CounterRng &rng)
+    {
+        const int r = roomOf[cell];
+        if (r < 0) {
+            visited[cell] = 1;
+            stack.push_back(cell);
+            const QPoint t = tileOf(cell);
+            carve(t.x(), t.y());
+            return;
+        }
+        const Room &room = rooms[r];
+        const int n = room.w * room.h;
+        const int first = rng.below(n);
+        for (int i = 0; i < n; ++i) {
+            const int k = (first + i) % n;
+            const int c = (room.y + k / room.w) * cw + room.x + k % room.w;
+            visited[c] = 1;
+            stack.push_back(c);
+        }
+    }
+
+    void backtrack(CounterRng &rng, int start)
+    {
+        visit(start, rng);
+        while (!stack.empty()) {
+            const int c = stack.back();
+            const int cx = c % cw, cy = c / cw;
+            int choices[4], n = 0;
+            for (int d = 0; d < 4; ++d) {
+                const int nx = cx + kDirs[d][0], ny = cy + kDirs[d][1];
+                if (uint(nx) < uint(cw) && uint(ny) < uint(ch) && !visited[ny * cw + nx])
+                    choices[n++] = d;
+            }
+            if (n == 0) {
+                stack.pop_back();
+                continue;
+            }
+            const int d = choices[rng.below(n)];
+            carve(2 * cx + 1 + kDirs[d][0], 2 * cy + 1 + kDirs[d][1]);
+            visit((cy + kDirs[d][1]) * cw + cx + kDirs[d][0], rng);
+        }
+    }
+
+    // Non-overlapping rooms two to four cells a side, a cell apart
+    void placeRooms(CounterRng &rng)
+    {
+        if (cw < 4 || ch < 4)
+            return;
+        const int wanted = qMax(1, cw * ch / 36);
+        for (int tries = 0; tries < wanted * 4 && int(rooms.size()) < wanted; ++tries) {
+            Room r;
+            r.w = 2 + rng.below(3);
+            r.h = 2 + rng.below(3);
+            if (r.w > cw || r.h > ch) continue;
+            r.x = rng.below(cw - r.w + 1);
+            r.y = rng.below(ch - r.h + 1);
+            // Looked up in roomOf, one cell of margin around
+            bool clear = true;
+            for (int y = qMax(0, r.y - 1); clear && y <= qMin(ch - 1, r.y + r.h); ++y)
+                for (int x = qMax(0, r.x - 1); x <= qMin(cw - 1, r.x + r.w); ++x)
+                    if (roomOf[y * cw + x] >= 0) {
+                        clear = false;
+                        break;
+                    }
+            if (!clear) continue;
+
+            const int id = int(rooms.size());
+            rooms.push_back(r);
+            for (int y = r.y; y < r.y + r.h; ++y)
+                for (int x = r.x; x < r.x + r.w; ++x)
+                    roomOf[y * cw + x] = id;
+            for (int ty = 2 * r.y + 1; ty < 2 * (r.y + r.h); ++ty)
+                for (int tx = 2 * r.x + 1; tx < 2 * (r.x + r.w); ++tx)
+                    carve(tx, ty);
+        }
+    }
+
+    // Knocks each dead end through to a neighbouring cell, percent of the
+    // time; another dead end is preferred so one hole fixes two
+    void braid(CounterRng &rng, int percent)
+    {
+        for (int cy = 0; cy < ch; ++cy)
+            for (int cx = 0; cx < cw; ++cx) {
+                const int tx = 2 * cx + 1, ty = 2 * cy + 1;
+                if (openAround(tx, ty) != 1 || rng.below(100) >= percent)
+                    continue;
+                int all[4], deadEnds[4], n = 0, m = 0;
+                for (int d = 0; d < 4; ++d) {
+                    const int nx = cx + kDirs[d][0], ny = cy + kDirs[d][1];
+                    if (uint(nx) >= uint(cw) || uint(ny) >= uint(ch)
+                        || isOpen(tx + kDirs[d][0], ty + kDirs[d][1]))
+                        continue;
+                    all[n++] = d;
+                    if (openAround(2 * nx + 1, 2 * ny + 1) == 1)
+                        deadEnds[m++] = d;
+                }
+                if (n == 0) continue;
+                const int d = m > 0 ? deadEnds[rng.below(m)] : all[rng.below(n)];
+                carve(tx + kDirs[d][0], ty + kDirs[d][1]);
+            }
+    }
+
+    // Whole runs along a row at once, carried across word boundaries
+    void fillRow(quint64 *r, const quint64 *o) const
+    {
+        quint64 carry = 0;
+        for (int k = 0; k < words; ++k) {
+            r[k] = fillUp(r[k] | (carry & o[k]), o[k]);
+            carry = r[k] >> 63;
+        }
+        carry = 0;
+        for (int k = words - 1; k >= 0; --k) {
+            r[k] = fillDown(r[k] | ((carry << 63) & o[k]), o[k]);
+            carry = r[k] & 1;
+        }
+    }
+
+    // Bit-parallel flood fill: sweeps down and up, each row taking what
+    // reached the row before and filling along itself, until a round
+    // changes nothing. Rounds grow with how often paths double back
+    // vertically, not with their length; a winding maze (a perfect one
+    // above all) can need thousands, so past kMaxFillRounds the rest is
+    // filled cell by cell instead.
+    bool fillsAll(QPoint spawn)
+    {
+        if (!isOpen(spawn.x(), spawn.y()))
+            return false;
+        std::fill(reach.begin(), reach.end(), 0);
+        quint64 *seed = row(reach, spawn.y());
+        seed[spawn.x() >> 6] |= quint64(1) << (spawn.x() & 63);
+        fillRow(seed, row(open, spawn.y()));
+
+        bool changed = true;
+        for (int round = 0; changed; ++round) {
+            if (round == kMaxFillRounds) {
+                fillCells();
+                break;
+            }
+            changed = false;
+            for (int pass = 0; pass < 2; ++pass) {
+                const int step = pass == 0 ? 1 : -1;
+                int y = pass == 0 ? 0 : rows - 1;
+                for (; y >= 0 && y < rows; y += step) {
+                    quint64 *r = row(reach, y);
+                    const quint64 *o = row(open, y);
+                    const quint64 *from = (y - step >= 0 && y - step < rows) ? row(reach, y - step) : nullptr;
+                    bool grew = false;
+                    for (int k = 0; k < words; ++k) {
+                        const quint64 in = from ? from[k] & o[k] & ~r[k] : 0;
+                        grew |= in != 0;
+                        r[k] |= in;
+                    }
+                    if (grew) {
+                        fillRow(r, o);
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < open.size(); ++i)
+            if (open[i] != reach[i])
+                return false;
+        return true;
+    }
+
+    // Open and not reached yet
+    quint64 unreached(int y, int k) const
+    {
+        if (y < 0 || y >= rows || k < 0 || k >= words) return 0;
+        return row(open, y)[k] & ~row(reach, y)[k];
+    }
+
+    // O(cells) depth-first fill, on from the reached cells next to an
+    // unreached one. Cells go on the stack as y << 13 | x.
+    void fillCells()
+    {
+        stack.clear();
+        for (int y = 0; y < rows; ++y) {
+            const quint64 *r = row(reach, y);
+            for (int k = 0; k < words; ++k) {
+                const quint64 u = unreached(y, k);
+                const quint64 next = (u >> 1) | (unreached(y, k + 1) << 63)
+                    | (u << 1) | (unreached(y, k - 1) >> 63)
+                    | unreached(y - 1, k) | unreached(y + 1, k);
+                for (quint64 b = r[k] & next; b; b &= b - 1)
+                    stack.push_back(y << 13 | (k * 64 + qCountTrailingZeroBits(b)));
+            }
+        }
+        while (!stack.empty()) {
+            const int c = stack.back();
+            stack.pop_back();
+            const int x = c & 8191, y = c >> 13;
+            for (const auto &d : kDirs) {
+                const int nx = x + d[0], ny = y + d[1];
+                if (!isOpen(nx, ny))
+                    continue;
+                quint64 &w = row(reach, ny)[nx >> 6];
+                const quint64 bit = quint64(1) << (nx & 63);
+                if (w & bit)
+                    continue;
+                w |= bit;
+                stack.push_back(ny << 13 | nx);
+            }
+        }
+    }
+
+    // Wall grid, a word of tiles at a time; both are LSB first
+    BitGrid walls() const
+    {
+        BitGrid grid(cols, rows);
+        uchar *bits = grid.bits();
+        const int stride = grid.stride();
+        for (int y = 0; y < rows; ++y) {
+            const quint64 *o = row(open, y);
+            uchar *out = bits + size_t(y) * stride;
+            for (int k = 0; k < words; ++k) {
+                uchar word[8];
+                qToLittleEndian<quint64>(~o[k], word);
+                std::memcpy(out + k * 8, word, size_t(qMin(8, stride - k * 8)));
+            }
+            if (cols & 7)
+                out[stride - 1] &= uchar((1 << (cols & 7)) - 1);
+        }
+        return grid;
+    }
+
+    // Neighbour counts a word at a time, bit-sliced into three planes
+    Stats measure() const
+    {
+        Stats s;
+        qint64 edges = 0;
+        for (int y = 0; y < rows; ++y) {
+            const quint64 *o = row(open, y);
+            const quint64 *up = y > 0 ? row(open, y - 1) : nullptr;
+            const quint64 *down = y + 1 < rows ? row(open, y + 1) : nullptr;
+            for (int k = 0; k < words; ++k) {
+                const quint64 c = o[k];
+                const quint64 e = (c >> 1) | (k + 1 < words ? o[k + 1] << 63 : 0);
+                const quint64 w = (c << 1) | (k > 0 ? o[k - 1] >> 63 : 0);
+                const quint64 n = up ? up[k] : 0;
+                const quint64 sth = down ? down[k] : 0;
+
+                const quint64 p = e ^ w, q = e & w, r = n ^ sth, t = n & sth;
+                const quint64 ones = p ^ r, carry = p & r;
+                const quint64 twos = q ^ t ^ carry;
+                const quint64 fours = (q & t) | (q & carry) | (t & carry);
+
+                s.openCells += qPopulationCount(c);
+                s.deadEnds += qPopulationCount(c & ones & ~twos & ~fours);
+                s.junctions += qPopulationCount(c & ((ones & twos) | fours));
+                edges += qPopulationCount(c & e) + qPopulationCount(c & sth);
+            }
+        }
+        s.loops = s.openCells > 0 ? int(edges - s.openCells + 1) : 0;
+
+        // Dead ends are where Pac-Man gets cornered, loops are the way out
+        const int ends = s.deadEnds + s.junctions;
+        const double trap = ends > 0 ? double(s.deadEnds) / ends : 1.0;
+        const double escape = qMin(1.0, 12.0 * s.loops / qMax(1, s.openCells));
+        s.difficulty = qRound(100.0 * (0.6 * trap + 0.4 * (1.0 - escape)));
+        return s;
+    }
+};
+
+QColor enemyColor(int index)
+{
+    static const Qt::GlobalColor palette[] = {
+        Qt::red, Qt::magenta, Qt::cyan, Qt::green, Qt::blue, Qt::white
+    };
+    return palette[index % int(std::size(palette))];
+}
+
+// Smart enemies chase within this many cells of where they start, so a
+// big board costs no more per enemy than a small one
+constexpr int kHabitatRadius = 24;
+
+// Enemies on cells at least a quarter of the way across from the spawn,
+// every third one smart
+void placeEnemies(Generator &g, CounterRng &rng, QPoint spawn, int wanted, LevelData &level)
+{
+    const int minDistance = (g.cols + g.rows) / 4;
+    for (int tries = 0; tries < wanted * 16 && int(level.enemies.size()) < wanted; ++tries) {
+        const QPoint t = g.tileOf(rng.below(g.cw * g.ch));
+        if ((t - spawn).manhattanLength() < minDistance)
+            continue;
+        bool taken = false;
+        for (const Enemy &e : level.enemies)
+            taken |= e.x == t.x() && e.y == t.y();
+        if (taken) continue;
+
+        int dx = 0, dy = 0;
+        const int first = rng.below(4);
+        for (int i = 0; i < 4; ++i) {
+            const auto &d = kDirs[(first + i) % 4];
+            if (g.isOpen(t.x() + d[0], t.y() + d[1])) {
+                dx = d[0]; dy = d[1];
+                break;
+            }
+        }
+        const int i = level.enemies.size();
+        const QRect habitat = QRect(0, 0, g.cols, g.rows).intersected(
+            QRect(t.x() - kHabitatRadius, t.y() - kHabitatRadius,
+                  2 * kHabitatRadius + 1, 2 * kHabitatRadius + 1));
+        level.enemies.append(Enemy{ t.x(), t.y(), dx, dy, enemyColor(i),
+                                    i % 3 == 0 ? EnemyType::Smart : EnemyType::Simple,
+                                    habitat, 1, i % 2 });
+    }
+}
+
+} // namespace
+
+namespace MazeGenerator {
+
+QString styleName(Style style)
+{
+    switch (style) {
+    case Style::Backtracker: return "backtracker";
+    case Style::Braided: return "braided";
+    case Style::Rooms: return "rooms";
+    }
+    return QString();
+}
+
+bool parseStyle(const QString &name, Style *out)
+{
+    for (Style s : { Style::Backtracker, Style::Braided, Style::Rooms })
+        if (name.compare(styleName(s), Qt::CaseInsensitive) == 0) {
+            *out = s;
+            return true;
+        }
+    return false;
+}
+
+bool generate(quint64 seed, quint64 index, const Options &options, LevelData *out, Stats *stats)
+{
+    if (options.cols < kMinSide || options.rows < kMinSide
+        || options.cols > LevelPack::kMaxSide || options.rows > LevelPack::kMaxSide)
+        return false;
+
+    thread_local Generator g;
+    const quint64 levelKey = CounterRng::mix(seed ^ CounterRng::mix(index + 1));
+    const int attempts = qMax(1, options.maxAttempts);
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        CounterRng rng(CounterRng::mix(levelKey + quint64(attempt)));
+        g.reset(options.cols, options.rows);
+        const int start = (g.ch / 2) * g.cw + g.cw / 2;
+        switch (options.style) {
+        case Style::Backtracker:
+            g.backtrack(rng, start);
+            break;
+        case Style::Braided:
+            g.backtrack(rng, start);
+            g.braid(rng, 100);
+            break;
+        case Style::Rooms:
+            g.placeRooms(rng);
+            g.backtrack(rng, start);
+            g.braid(rng, 50);
+            break;
+        }
+
+        const QPoint spawn = g.tileOf(start);
+        if (!g.fillsAll(spawn))
+            continue;
+        Stats s = g.measure();
+        s.attempts = attempt + 1;
+        if (s.difficulty < options.minDifficulty || s.difficulty > options.maxDifficulty)
+            continue;
+
+        if (stats) *stats = s;
+        if (!out) return true;
+
+        LevelData &l = *out;
+        l = LevelData();
+        l.name = QString("%1 %2").arg(styleName(options.style)).arg(index + 1);
+        l.walls = g.walls();
+        l.playerStart = spawn;
+        placeEnemies(g, rng, spawn, options.enemies, l);
+        return true;
+    }
+    if (stats) {
+        *stats = Stats();
+        stats->attempts = attempts;
+    }
+    return false;
+}
+
+QVector<LevelData> generateMany(quint64 seed, int count, const Options &options,
+                                int landmarks, int *failed)
+{
+    // Big enough to amortise scheduling, small enough to balance
+    constexpr int kChunk = 64;
+    QVector<int> chunks;
+    for (int first = 0; first < count; first += kChunk)
+        chunks.append(first);
+
+    std::atomic<int> misses{0};
+    const auto parts = QtConcurrent::blockingMapped<QVector<QVector<LevelData>>>(chunks,
+        [&](int first) {
+            QVector<LevelData> part;
+            for (int i = first; i < qMin(count, first + kChunk); ++i) {
+                LevelData l;
+                if (!generate(seed, quint64(i), options, &l)) {
+                    ++misses;
+                    continue;
+                }
+                LevelCompiler::compile(l, landmarks);
+                part.append(l);
+            }
+            return part;
+        });
+
+    QVector<LevelData> levels;
+    levels.reserve(count);
+    for (const QVector<LevelData> &part : parts)
+        levels += part;
+    if (failed) *failed = misses;
+    return levels;
+}
+
+}
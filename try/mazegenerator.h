@@ -0,0 +1,93 @@
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include <QString>
+#include <QVector>
+
+#include "levelpack.h"
+
+// ==============================
+// 🎲 MAZE GENERATOR
+// ==============================
+
+// Procedural levels for filling packs. Each candidate is carved on a word
+// per 64 cells grid, then checked with a bit-parallel flood fill (every
+// open cell reachable from the spawn) and given a difficulty score; one
+// that fails is thrown away and the next attempt tried.
+//
+// Draws come from a counter-based RNG keyed by (seed, index, attempt), so
+// level N of a seed is the same whichever thread made it and however
+// many levels were made before it.
+//
+// Styles:
+//   Backtracker  recursive backtracker, a perfect maze: no loops, lots
+//                of dead ends
+//   Braided      backtracker with every dead end knocked through, the
+//                closest to a Pac-Man board
+//   Rooms        open rooms joined by backtracker corridors, half the
+//                dead ends braided
+namespace MazeGenerator {
+
+enum class Style : quint8 { Backtracker, Braided, Rooms };
+
+struct Options {
+    Style style = Style::Braided;
+    int cols = 25, rows = 25;       // odd sizes use the last row/column too
+    int enemies = 4;
+    int minDifficulty = 0;          // candidates outside are rejected
+    int maxDifficulty = 100;
+    int maxAttempts = 64;
+};
+
+// What validation measured on the accepted candidate
+struct Stats {
+    int openCells = 0;
+    int deadEnds = 0;
+    int junctions = 0;
+    int loops = 0;                  // independent cycles, edges - cells + 1
+    int difficulty = 0;             // 0 wide open .. 100 perfect maze
+    int attempts = 0;
+};
+
+// SplitMix64 run as a counter: draw i is mix(key + i * golden), nothing
+// else carried between draws
+class CounterRng
+{
+public:
+    explicit CounterRng(quint64 key) : key(key) {}
+
+    static constexpr quint64 mix(quint64 z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    quint64 next() { return mix(key + ++counter * 0x9E3779B97F4A7C15ull); }
+
+    // 0..n-1, n > 0
+    int below(int n) { return int((quint64(quint32(next() >> 32)) * quint32(n)) >> 32); }
+
+private:
+    quint64 key;
+    quint64 counter = 0;
+};
+
+QString styleName(Style style);
+bool parseStyle(const QString &name, Style *out);
+
+// Level `index` of `seed`: walls, spawn and enemies, not yet compiled.
+// out may be null to only generate and validate. False when no attempt
+// passed within maxAttempts or the size is out of range.
+bool generate(quint64 seed, quint64 index, const Options &options,
+              LevelData *out, Stats *stats = nullptr);
+
+// Levels 0..count-1 of `seed`, made in parallel on the global thread pool
+// and returned in index order, compiled and ready to pack. Indices that
+// never validated are left out and counted in *failed.
+QVector<LevelData> generateMany(quint64 seed, int count, const Options &options,
+                                int landmarks, int *failed = nullptr);
+
+}
+
+#endif // MAZEGENERATOR_H
@@ -0,0 +1,182 @@
+#include "mazerouter.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+
+const int kDirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+} // namespace
+
+void MazeRouter::setLevel(const LevelData &level)
+{
+    graph = level.graph;
+    landmarks = level.landmarks;
+    cols = level.walls.cols();
+    rows = level.walls.rows();
+    if (graph.cellData.size() != qsizetype(cols) * rows * qsizetype(sizeof(GraphCell)))
+        graph = LevelGraph();
+    scratch.fill(Scratch(), graph.nodeCount());
+    epoch = 0;
+}
+
+GraphCell MazeRouter::cellAt(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= cols || y >= rows || graph.isEmpty())
+        return GraphCell{ GraphCell::kNone, 0 };
+    return graph.cells()[y * cols + x];
+}
+
+bool MazeRouter::stepTo(QPoint at, GraphCell want, int &dx, int &dy) const
+{
+    for (const auto &d : kDirs) {
+        const GraphCell c = cellAt(at.x() + d[0], at.y() + d[1]);
+        if (c.ref == want.ref && c.offset == want.offset) {
+            dx = d[0];
+            dy = d[1];
+            return true;
+        }
+    }
+    return false;
+}
+
+// One anchor for a node cell, the two corridor ends for anything else
+int MazeRouter::anchorsOf(QPoint p, Anchor out[2]) const
+{
+    const GraphCell c = cellAt(p.x(), p.y());
+    if (c.ref == GraphCell::kNone)
+        return 0;
+    if (c.isNode()) {
+        out[0] = Anchor{ int(c.ref & ~GraphCell::kNodeBit), 0, 0, 0, 0, 0 };
+        return 1;
+    }
+
+    const GraphEdge &e = graph.edges()[c.ref];
+    const int from = graph.sourceOf(int(c.ref));
+    const GraphCell back = c.offset == 1 ? GraphCell{ GraphCell::kNodeBit | quint32(from), 0 }
+                                         : GraphCell{ c.ref, c.offset - 1 };
+    const GraphCell ahead = c.offset + 1 == e.length ? GraphCell{ GraphCell::kNodeBit | e.to, 0 }
+                                                     : GraphCell{ c.ref, c.offset + 1 };
+    const GraphNode &to = graph.nodes()[e.to];
+    int n = 0, dx = 0, dy = 0, inDx = 0, inDy = 0;
+    if (stepTo(p, back, dx, dy))
+        out[n++] = Anchor{ from, int(c.offset), dx, dy, e.dx, e.dy };
+    if (stepTo(p, ahead, dx, dy)
+        && stepTo(QPoint(to.x, to.y), GraphCell{ c.ref, e.length - 1 }, inDx, inDy))
+        out[n++] = Anchor{ int(e.to), int(e.length - c.offset), dx, dy, inDx, inDy };
+    return n;
+}
+
+int MazeRouter::heuristic(int node, QPoint to) const
+{
+    const GraphNode &n = graph.nodes()[node];
+    const int manhattan = qAbs(n.x - to.x()) + qAbs(n.y - to.y());
+    if (!landmarks.count || landmarks.cells != cols * rows)
+        return manhattan;
+    return qMax(manhattan, landmarks.lowerBound(n.y * cols + n.x, to.y() * cols + to.x()));
+}
+
+bool MazeRouter::sameCorridor(QPoint a, QPoint b) const
+{
+    GraphCell ca = cellAt(a.x(), a.y()), cb = cellAt(b.x(), b.y());
+    if (ca.ref == GraphCell::kNone || cb.ref == GraphCell::kNone)
+        return false;
+    if (ca.isNode())
+        std::swap(ca, cb);
+    if (ca.isNode())
+        return false;
+    if (cb.isCorridor())
+        return ca.ref == cb.ref;
+    const int node = int(cb.ref & ~GraphCell::kNodeBit);
+    return node == int(graph.edges()[ca.ref].to) || node == graph.sourceOf(int(ca.ref));
+}
+
+bool MazeRouter::corridorAhead(QPoint at, QPoint from, int &dx, int &dy) const
+{
+    if (!inCorridor(at.x(), at.y()) || qAbs(at.x() - from.x()) + qAbs(at.y() - from.y()) != 1
+        || cellAt(from.x(), from.y()).ref == GraphCell::kNone)
+        return false;
+    for (const auto &d : kDirs) {
+        const QPoint n(at.x() + d[0], at.y() + d[1]);
+        if (n != from && cellAt(n.x(), n.y()).ref != GraphCell::kNone) {
+            dx = d[0];
+            dy = d[1];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MazeRouter::firstStep(QPoint from, QPoint to, int &dx, int &dy)
+{
+    expanded = 0;
+    Anchor src[2], dst[2];
+    const int srcCount = anchorsOf(from, src);
+    const int dstCount = anchorsOf(to, dst);
+    if (from == to || !srcCount || !dstCount)
+        return false;
+
+    int best = std::numeric_limits<int>::max();
+    int bestDx = 0, bestDy = 0;
+
+    // Same corridor: straight along it. The search below can still find
+    // a shorter way round if the corridor loops back on itself.
+    const GraphCell cf = cellAt(from.x(), from.y()), ct = cellAt(to.x(), to.y());
+    if (cf.isCorridor() && ct.isCorridor() && cf.ref == ct.ref && srcCount == 2) {
+        const Anchor &a = ct.offset > cf.offset ? src[1] : src[0];
+        best = qAbs(int(ct.offset) - int(cf.offset));
+        bestDx = a.dx;
+        bestDy = a.dy;
+    }
+
+    if (++epoch == 0) {
+        scratch.fill(Scratch());
+        epoch = 1;
+    }
+    heap.clear();
+    for (int i = 0; i < srcCount; ++i) {
+        Scratch &s = scratch[src[i].node];
+        if (s.stamp == epoch && s.dist <= src[i].cost) continue;
+        s = Scratch{ epoch, src[i].cost, qint8(src[i].dx), qint8(src[i].dy) };
+        heap.push_back(QueueEntry{ src[i].cost + heuristic(src[i].node, to), src[i].cost, src[i].node });
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    const GraphNode *nodes = graph.nodes();
+    const GraphEdge *edges = graph.edges();
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        const QueueEntry cur = heap.back();
+        heap.pop_back();
+        if (cur.f >= best) break;
+        const Scratch s = scratch[cur.node];
+        if (cur.g > s.dist) continue;
+        ++expanded;
+
+        for (int i = 0; i < dstCount; ++i) {
+            if (dst[i].node != cur.node || cur.g + dst[i].cost >= best) continue;
+            best = cur.g + dst[i].cost;
+            bestDx = s.dx || s.dy ? s.dx : dst[i].inDx;
+            bestDy = s.dx || s.dy ? s.dy : dst[i].inDy;
+        }
+
+        const GraphNode &n = nodes[cur.node];
+        for (quint32 k = n.firstEdge; k < n.firstEdge + n.edgeCount; ++k) {
+            const GraphEdge &e = edges[k];
+            const int g = cur.g + int(e.length);
+            Scratch &t = scratch[e.to];
+            if (t.stamp == epoch && t.dist <= g) continue;
+            const bool atStart = !s.dx && !s.dy;
+            t = Scratch{ epoch, g, atStart ? e.dx : s.dx, atStart ? e.dy : s.dy };
+            heap.push_back(QueueEntry{ g + heuristic(int(e.to), to), g, int(e.to) });
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    if (best == std::numeric_limits<int>::max() || (!bestDx && !bestDy))
+        return false;
+    dx = bestDx;
+    dy = bestDy;
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef MAZEROUTER_H
+#define MAZEROUTER_H
+
+#include <QPoint>
+#include <QVector>
+#include <vector>
+
+#include "levelpack.h"
+
+// ==============================
+// 🧭 MAZE ROUTER
+// ==============================
+
+// Path queries on a level's junction graph instead of its cells. A
+// corridor is one weighted edge, so a search only ever touches junctions
+// and dead ends; the cell table in LevelGraph says which corridor (and
+// how far along it) any cell is. Enemies use it to pick a way at a
+// junction and otherwise just keep following the corridor they are in.
+//
+// Scratch space is kept between queries and reset by stamping, so a
+// query allocates nothing once the level is set. Not thread safe; the
+// simulation owns one.
+class MazeRouter
+{
+public:
+    // Borrows the level's graph and tables; call again whenever it changes
+    void setLevel(const LevelData &level);
+
+    // False when the level has no graph, e.g. one compiled by an older tool
+    bool isValid() const { return !graph.isEmpty(); }
+
+    bool isJunction(int x, int y) const { return cellAt(x, y).isNode(); }
+    bool inCorridor(int x, int y) const { return cellAt(x, y).ref != GraphCell::kNone && cellAt(x, y).isCorridor(); }
+
+    // Both cells on the same corridor, its end nodes included
+    bool sameCorridor(QPoint a, QPoint b) const;
+
+    // The way on out of a corridor cell, entered from `from`. False if
+    // `from` is not one of its two open neighbours.
+    bool corridorAhead(QPoint at, QPoint from, int &dx, int &dy) const;
+
+    // First move of a shortest path, or false if there is none or either
+    // cell is off the graph
+    bool firstStep(QPoint from, QPoint to, int &dx, int &dy);
+
+    // Nodes settled by the last firstStep()
+    int lastExpanded() const { return expanded; }
+
+private:
+    // A node reachable from a cell by walking `cost` steps, the first of
+    // them in direction (dx, dy), and the way back in from the node. Both
+    // are zero when the cell is the node.
+    struct Anchor {
+        int node;
+        int cost;
+        int dx, dy;
+        int inDx, inDy;
+    };
+
+    struct QueueEntry {
+        int f, g, node;
+        // Min-heap on f, deeper first on ties
+        bool operator<(const QueueEntry &o) const { return f != o.f ? f > o.f : g < o.g; }
+    };
+
+    GraphCell cellAt(int x, int y) const;
+    int anchorsOf(QPoint p, Anchor out[2]) const;
+    bool stepTo(QPoint at, GraphCell want, int &dx, int &dy) const;
+    int heuristic(int node, QPoint to) const;
+
+    LevelGraph graph;
+    LandmarkTable landmarks;
+    int cols = 0, rows = 0;
+
+    // Per-node scratch, valid where stamp == epoch
+    struct Scratch {
+        quint32 stamp = 0;
+        int dist = 0;
+        qint8 dx = 0, dy = 0;
+    };
+    QVector<Scratch> scratch;
+    std::vector<QueueEntry> heap;
+    quint32 epoch = 0;
+    int expanded = 0;
+};
+
+#endif // MAZEROUTER_H
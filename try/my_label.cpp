@@ -21,3 +21,18 @@ void MyLabel::mousePressEvent(QMouseEvent *ev)
         emit sendMousePosition(pos);
     }
 }
+
+void MyLabel::resizeEvent(QResizeEvent *ev)
+{
+    QLabel::resizeEvent(ev);
+    emit resized();
+}
+
+bool MyLabel::event(QEvent *ev)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    if (ev->type() == QEvent::DevicePixelRatioChange)
+        emit resized();
+#endif
+    return QLabel::event(ev);
+}
@@ -15,10 +15,13 @@ public:
 protected:
     void mouseMoveEvent(QMouseEvent *ev) override;
     void mousePressEvent(QMouseEvent *ev) override;
+    void resizeEvent(QResizeEvent *ev) override;
+    bool event(QEvent *ev) override;
 
 signals:
     void sendMousePosition(QPoint &pos);  // Emits current mouse position
     void Mouse_Pressed();                 // Emits when mouse is clicked
+    void resized();                       // Emits on resize or DPR change
 };
 
 #endif // MY_LABEL_H
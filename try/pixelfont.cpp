@@ -0,0 +1,48 @@
+#include "pixelfont.h"
+
+namespace {
+
+const PixelGlyph kGlyphs[] = {
+    { u' ', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },   // space
+    { u'0', { 0x38, 0x4C, 0xC6, 0xC6, 0xC6, 0x64, 0x38, 0x00 } },   // 0
+    { u'1', { 0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0xFC, 0x00 } },   // 1
+    { u'2', { 0x7C, 0xC6, 0x06, 0x1C, 0x78, 0xC0, 0xFE, 0x00 } },   // 2
+    { u'3', { 0x7E, 0x0C, 0x18, 0x3C, 0x06, 0xC6, 0x7C, 0x00 } },   // 3
+    { u'4', { 0x1C, 0x3C, 0x6C, 0xCC, 0xFE, 0x0C, 0x0C, 0x00 } },   // 4
+    { u'5', { 0xFC, 0xC0, 0xFC, 0x06, 0x06, 0xC6, 0x7C, 0x00 } },   // 5
+    { u'6', { 0x3C, 0x60, 0xC0, 0xFC, 0xC6, 0xC6, 0x7C, 0x00 } },   // 6
+    { u'7', { 0xFE, 0xC6, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x00 } },   // 7
+    { u'8', { 0x78, 0xC4, 0xE4, 0x78, 0x9E, 0x86, 0x7C, 0x00 } },   // 8
+    { u'9', { 0x7C, 0xC6, 0xC6, 0x7E, 0x06, 0x0C, 0x78, 0x00 } },   // 9
+    { u':', { 0x00, 0x30, 0x30, 0x00, 0x30, 0x30, 0x00, 0x00 } },   // :
+    { u'C', { 0x3C, 0x66, 0xC0, 0xC0, 0xC0, 0x66, 0x3C, 0x00 } },   // C
+    { u'E', { 0xFE, 0xC0, 0xC0, 0xFC, 0xC0, 0xC0, 0xFE, 0x00 } },   // E
+    { u'I', { 0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7E, 0x00 } },   // I
+    { u'L', { 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7E, 0x00 } },   // L
+    { u'O', { 0x7C, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0x7C, 0x00 } },   // O
+    { u'R', { 0xFC, 0xC6, 0xC6, 0xCE, 0xF8, 0xDC, 0xCE, 0x00 } },   // R
+    { u'S', { 0x78, 0xCC, 0xC0, 0x7C, 0x06, 0xC6, 0x7C, 0x00 } },   // S
+    { u'V', { 0xC6, 0xC6, 0xC6, 0xEE, 0x7C, 0x38, 0x10, 0x00 } },   // V
+    { 0x2665, { 0x6C, 0xFE, 0xFE, 0xFE, 0x7C, 0x38, 0x10, 0x00 } },   // ♥
+    { 0x2620, { 0x3C, 0x7E, 0xDB, 0xFF, 0x66, 0x3C, 0x24, 0x00 } },   // ☠
+};
+
+} // namespace
+
+const PixelGlyph *PixelFont::glyphs()
+{
+    return kGlyphs;
+}
+
+int PixelFont::glyphCount()
+{
+    return int(sizeof(kGlyphs) / sizeof(kGlyphs[0]));
+}
+
+int PixelFont::indexOf(QChar c)
+{
+    for (int i = 0; i < glyphCount(); ++i)
+        if (kGlyphs[i].code == c.unicode())
+            return i;
+    return -1;
+}
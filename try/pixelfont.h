@@ -0,0 +1,31 @@
+#ifndef PIXELFONT_H
+#define PIXELFONT_H
+
+#include <QChar>
+
+// ==============================
+// 🔤 8x8 RETRO BITMAP FONT
+// ==============================
+
+// Blocky 8x8 glyphs in the 'Press Start 2P' style, compiled into the
+// binary so the HUD never touches the font database. Only the characters
+// the HUD actually prints are included; bit 7 of each row is the
+// leftmost pixel.
+struct PixelGlyph {
+    char16_t code;
+    unsigned char rows[8];
+};
+
+namespace PixelFont {
+
+constexpr int kGlyphSize = 8;
+
+const PixelGlyph *glyphs();
+int glyphCount();
+
+// Index into glyphs(), or -1 if the character is not in the font.
+int indexOf(QChar c);
+
+} // namespace PixelFont
+
+#endif // PIXELFONT_H
@@ -0,0 +1,221 @@
+#include "renderthread.h"
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <chrono>
+#include <utility>
+
+namespace {
+
+// How far through the tick period a snapshot is, 0..1
+float tickProgress(const GameSnapshot &s, qint64 nowNs)
+{
+    if (s.periodNs <= 0) return 1.0f;
+    return float(qBound<qint64>(0, nowNs - s.tickNs, s.periodNs)) / float(s.periodNs);
+}
+
+bool inMotion(const GameSnapshot &s)
+{
+    if (s.playerFromX != s.playerX || s.playerFromY != s.playerY)
+        return true;
+    if (s.enemiesFrom.size() != s.enemies.size())
+        return false;
+    for (int i = 0; i < s.enemies.size(); ++i)
+        if (s.enemiesFrom[i] != QPoint(s.enemies[i].x, s.enemies[i].y))
+            return true;
+    return false;
+}
+
+} // namespace
+
+RenderThread::RenderThread(TripleBuffer<GameSnapshot> &source, QObject *parent)
+    : QThread(parent), source(source)
+{
+    setObjectName("render");
+    for (int slot : { FrameRenderer::SlotBackground, FrameRenderer::SlotWall,
+                      FrameRenderer::SlotFood, FrameRenderer::SlotPlayer })
+        palette[slot] = raster.paletteColor(slot);
+}
+
+RenderThread::~RenderThread()
+{
+    requestStop();
+    wait();
+}
+
+void RenderThread::setViewport(const QSize &size, int minCell)
+{
+    QMutexLocker locker(&lock);
+    minCell = qMax(1, minCell);
+    if (size == viewport && minCell == minCellSize) return;
+    viewport = size;
+    minCellSize = minCell;
+    pending = true;
+    work.wakeOne();
+}
+
+int RenderThread::cellSizeFor(int cols, int rows, const QSize &view, int minCell)
+{
+    if (view.isEmpty() || cols <= 0 || rows <= 0)
+        return 0;
+    return qMax(minCell, qMin(view.width() / cols, view.height() / rows));
+}
+
+void RenderThread::setFramePeriod(qint64 ns)
+{
+    QMutexLocker locker(&lock);
+    framePeriodNs = qMax<qint64>(1000000, ns);
+}
+
+void RenderThread::setPaletteColor(int slot, const QColor &color)
+{
+    QMutexLocker locker(&lock);
+    palette[slot] = color;
+    paletteChanges[slot] = color;
+    pending = true;
+    work.wakeOne();
+}
+
+QColor RenderThread::paletteColor(int slot) const
+{
+    QMutexLocker locker(&lock);
+    return palette.value(slot);
+}
+
+void RenderThread::wake()
+{
+    QMutexLocker locker(&lock);
+    pending = true;
+    work.wakeOne();
+}
+
+void RenderThread::prepareWalls(const BitGrid &maze)
+{
+    QMutexLocker locker(&lock);
+    upcomingWalls = maze;
+    pending = true;
+    work.wakeOne();
+}
+
+void RenderThread::requestStop()
+{
+    QMutexLocker locker(&lock);
+    stopping = true;
+    work.wakeOne();
+}
+
+TimingHistogram RenderThread::renderTimes() const
+{
+    QMutexLocker locker(&lock);
+    return renders;
+}
+
+void RenderThread::resetStats()
+{
+    QMutexLocker locker(&lock);
+    renders.reset();
+}
+
+void RenderThread::run()
+{
+    QSize renderedViewport;
+    int renderedMinCell = 0;
+    bool animating = false;
+    QElapsedTimer clock;
+    clock.start();
+
+    forever {
+        QSize view;
+        int minCell;
+        QMap<int, QColor> changes;
+        BitGrid upcoming;
+        // Walls that can't be prepared this pass go back for the next one,
+        // unless a newer preload took their place
+        const auto keepUpcoming = [&]() {
+            QMutexLocker locker(&lock);
+            if (upcomingWalls.isEmpty())
+                std::swap(upcoming, upcomingWalls);
+        };
+        {
+            QMutexLocker locker(&lock);
+            while (!pending && !stopping) {
+                if (!animating) {
+                    work.wait(&lock);
+                    continue;
+                }
+                // Mid-slide: time out for the next in-between frame
+                const QDeadlineTimer nextFrame(std::chrono::nanoseconds(framePeriodNs),
+                                               Qt::PreciseTimer);
+                if (!work.wait(&lock, nextFrame))
+                    break;
+            }
+            if (stopping) return;
+            pending = false;
+            view = viewport;
+            minCell = minCellSize;
+            changes.swap(paletteChanges);
+            std::swap(upcoming, upcomingWalls);
+        }
+
+        const qint64 t0 = clock.nsecsElapsed();
+        for (auto it = changes.cbegin(); it != changes.cend(); ++it)
+            raster.setPaletteColor(it.key(), it.value());
+
+        // New state, a new viewport or sprites still in motion mean a full
+        // raster; a palette change alone only re-expands the indexed frame
+        // Straight into the back slot, whose pixels are reused once the GUI
+        // has let go of them
+        QImage &img = finished.writeSlot();
+        bool drawn = false;
+        const bool fresh = source.update();
+        if (fresh || animating || view != renderedViewport || minCell != renderedMinCell) {
+            const GameSnapshot &s = source.read();
+            animating = false;
+            const int cs = cellSizeFor(s.cols, s.rows, view, minCell);
+            if (s.maze.isEmpty() || cs <= 0) {
+                keepUpcoming();
+                continue;
+            }
+
+            RenderScene scene;
+            scene.rows = s.rows;
+            scene.cols = s.cols;
+            scene.cellSize = cs;
+            scene.viewport = view;
+            scene.maze = &s.maze;
+            scene.food = &s.food;
+            scene.gridOrigin = s.gridOrigin;
+            scene.enemies = &s.enemies;
+            scene.playerX = s.playerX;
+            scene.playerY = s.playerY;
+            scene.playerDirX = s.playerDirX;
+            scene.playerDirY = s.playerDirY;
+            scene.mouthOpen = s.mouthOpen;
+            scene.enemiesFrom = &s.enemiesFrom;
+            scene.playerFromX = s.playerFromX;
+            scene.playerFromY = s.playerFromY;
+            scene.t = tickProgress(s, monotonicNs());
+            drawn = raster.render(scene, img);
+            renderedViewport = view;
+            renderedMinCell = minCell;
+            animating = scene.t < 1.0f && s.state == GameSnapshot::Running && inMotion(s);
+        } else if (!changes.isEmpty()) {
+            drawn = raster.recolor(img);
+        }
+        if (drawn) {
+            finished.publish();
+            {
+                QMutexLocker locker(&lock);
+                renders.record(clock.nsecsElapsed() - t0);
+            }
+            emit frameReady();
+        }
+
+        // After the frame is out, so it never waits on this
+        if (upcoming.isEmpty())
+            continue;
+        if (view.isEmpty())
+            keepUpcoming();
+        else
+            raster.prepareWalls(upcoming, cellSizeFor(upcoming.cols(), upcoming.rows(), view, minCell));
+    }
+}
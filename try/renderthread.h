@@ -0,0 +1,95 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <QColor>
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "framerenderer.h"
+#include "framescheduler.h"
+#include "gametypes.h"
+#include "triplebuffer.h"
+
+// ==============================
+// 🧵 RENDER THREAD
+// ==============================
+
+// Middle stage of the input -> simulation -> render pipeline. Sleeps
+// until the simulation publishes a snapshot (or the GUI changes the scale
+// or palette), rasterizes the newest snapshot with FrameRenderer and
+// hands the finished image to the GUI thread through a triple buffer. A
+// slow frame only ever delays this thread; the simulation keeps ticking
+// and the GUI keeps presenting the last good image.
+//
+// While sprites are still sliding between the last two ticks the worker
+// also wakes itself once per display frame and re-renders the same
+// snapshot further along, so motion is smooth at the refresh rate while
+// the simulation stays at its own tick rate. Idle time between frames
+// goes to drawing the wall layer of the next level.
+//
+// Frames are at most the viewport; boards too big for it at the minimum
+// cell size are drawn through a camera that follows Pac-Man.
+class RenderThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit RenderThread(TripleBuffer<GameSnapshot> &source, QObject *parent = nullptr);
+    ~RenderThread() override;
+
+    // Only before start(); the worker owns the renderer afterwards.
+    FrameRenderer &renderer() { return raster; }
+
+    // GUI-side controls, applied before the next frame. size is the
+    // frame in device pixels; cells are the largest whole size that shows
+    // the entire board, but never below minCellSize, past which the board
+    // scrolls under a camera.
+    void setViewport(const QSize &size, int minCellSize);
+    void setFramePeriod(qint64 ns);
+    void setPaletteColor(int slot, const QColor &color);
+    QColor paletteColor(int slot) const;
+
+    // Any thread; wakes the worker to pick up a new snapshot.
+    void wake();
+
+    // Any thread; the worker draws this maze's wall layer between frames
+    // so the level that uses it starts without a stall.
+    void prepareWalls(const BitGrid &maze);
+    void requestStop();
+
+    // Reader side belongs to the GUI thread.
+    TripleBuffer<QImage> &frames() { return finished; }
+
+    TimingHistogram renderTimes() const;
+    void resetStats();
+
+    static int cellSizeFor(int cols, int rows, const QSize &viewport, int minCellSize);
+
+signals:
+    // Emitted on the worker after each publish; connect queued.
+    void frameReady();
+
+protected:
+    void run() override;
+
+private:
+    TripleBuffer<GameSnapshot> &source;
+    TripleBuffer<QImage> finished;
+    FrameRenderer raster;
+
+    mutable QMutex lock;
+    QWaitCondition work;
+    bool pending = true;          // render once on start
+    bool stopping = false;
+    QSize viewport;
+    int minCellSize = 1;
+    qint64 framePeriodNs = 16666667;
+    QMap<int, QColor> palette;    // GUI view of the palette
+    QMap<int, QColor> paletteChanges;
+    BitGrid upcomingWalls;
+    TimingHistogram renders;
+};
+
+#endif // RENDERTHREAD_H
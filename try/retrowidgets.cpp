@@ -0,0 +1,192 @@
+#include "retrowidgets.h"
+#include <QEnterEvent>
+#include <QFocusEvent>
+#include <QPainter>
+#include <QResizeEvent>
+
+namespace {
+
+QColor mix(const QColor &a, const QColor &b, qreal t)
+{
+    return QColor::fromRgbF(a.redF() + (b.redF() - a.redF()) * t,
+                            a.greenF() + (b.greenF() - a.greenF()) * t,
+                            a.blueF() + (b.blueF() - a.blueF()) * t);
+}
+
+constexpr int kLabelBorder = 3;
+constexpr int kLabelPadX = 16;
+constexpr int kLabelPadY = 8;
+
+} // namespace
+
+QFont retroFont(int pixelSize)
+{
+    QFont f("Press Start 2P");
+    f.setStyleHint(QFont::Monospace);
+    f.setPixelSize(pixelSize);
+    f.setBold(true);
+    f.setLetterSpacing(QFont::AbsoluteSpacing, 1);
+    return f;
+}
+
+// ----- RetroLabel -----
+RetroLabel::RetroLabel(const QString &text, QWidget *parent)
+    : QLabel(text, parent), phase(0)
+{
+    setAlignment(Qt::AlignCenter);
+    setFont(retroFont(18));
+
+    blinkTimer = new QTimer(this);
+    blinkTimer->setInterval(600);
+    connect(blinkTimer, &QTimer::timeout, this, &RetroLabel::toggleGlow);
+}
+
+QSize RetroLabel::sizeHint() const
+{
+    const QFontMetrics fm(font());
+    return QSize(fm.horizontalAdvance(text()) + 2 * (kLabelPadX + kLabelBorder) + 2,
+                 fm.height() + 2 * (kLabelPadY + kLabelBorder) + 2);
+}
+
+QSize RetroLabel::minimumSizeHint() const
+{
+    return sizeHint();
+}
+
+void RetroLabel::toggleGlow()
+{
+    phase = (phase + 1) % kGlowSteps;
+    update();
+}
+
+void RetroLabel::renderGlowFrames()
+{
+    const qreal dpr = devicePixelRatio();
+    frames.resize(kGlowSteps);
+    framesText = text();
+
+    const QRectF box = QRectF(rect()).adjusted(kLabelBorder / 2.0, kLabelBorder / 2.0,
+                                               -kLabelBorder / 2.0 - 2, -kLabelBorder / 2.0 - 2);
+    for (int i = 0; i < kGlowSteps; ++i) {
+        const qreal t = qreal(i) / (kGlowSteps - 1);
+        QPixmap pm(size() * dpr);
+        pm.setDevicePixelRatio(dpr);
+        pm.fill(Qt::transparent);
+
+        QPainter p(&pm);
+        p.setRenderHint(QPainter::Antialiasing);
+        // hard drop shadow
+        p.setPen(Qt::NoPen);
+        p.setBrush(Qt::black);
+        p.drawRoundedRect(box.translated(2, 2), 6, 6);
+
+        p.setPen(QPen(mix(QColor("#555555"), QColor("#777777"), t), kLabelBorder));
+        p.setBrush(mix(QColor("#1C1C1C"), QColor("#222222"), t));
+        p.drawRoundedRect(box, 6, 6);
+
+        p.setFont(font());
+        p.setPen(mix(QColor("#CCCCCC"), QColor("#FFFFFF"), t));
+        p.drawText(box, alignment(), framesText);
+        frames[i] = pm;
+    }
+}
+
+void RetroLabel::paintEvent(QPaintEvent *)
+{
+    if (frames.size() != kGlowSteps || framesText != text()
+        || frames[0].devicePixelRatio() != devicePixelRatio())
+        renderGlowFrames();
+
+    QPainter p(this);
+    p.drawPixmap(0, 0, frames[phase]);
+}
+
+void RetroLabel::resizeEvent(QResizeEvent *e)
+{
+    QLabel::resizeEvent(e);
+    frames.clear();
+}
+
+void RetroLabel::showEvent(QShowEvent *e)
+{
+    QLabel::showEvent(e);
+    blinkTimer->start();
+}
+
+void RetroLabel::hideEvent(QHideEvent *e)
+{
+    blinkTimer->stop();
+    QLabel::hideEvent(e);
+}
+
+// ----- RetroButton -----
+RetroButton::RetroButton(const QString &text, QWidget *parent)
+    : QPushButton(text, parent)
+{
+    setFont(retroFont(14));
+    setCursor(Qt::PointingHandCursor);
+
+    glowAnim = new QPropertyAnimation(this, "glow", this);
+    glowAnim->setDuration(150);
+}
+
+void RetroButton::setGlow(qreal value)
+{
+    glowLevel = value;
+    update();
+}
+
+QSize RetroButton::sizeHint() const
+{
+    const QFontMetrics fm(font());
+    return QSize(fm.horizontalAdvance(text()) + 32, fm.height() + 20);
+}
+
+void RetroButton::animateGlowTo(qreal target)
+{
+    glowAnim->stop();
+    glowAnim->setStartValue(glowLevel);
+    glowAnim->setEndValue(target);
+    glowAnim->start();
+}
+
+void RetroButton::enterEvent(QEnterEvent *e)
+{
+    QPushButton::enterEvent(e);
+    animateGlowTo(1.0);
+}
+
+void RetroButton::leaveEvent(QEvent *e)
+{
+    QPushButton::leaveEvent(e);
+    if (!hasFocus()) animateGlowTo(0.0);
+}
+
+void RetroButton::focusInEvent(QFocusEvent *e)
+{
+    QPushButton::focusInEvent(e);
+    animateGlowTo(1.0);
+}
+
+void RetroButton::focusOutEvent(QFocusEvent *e)
+{
+    QPushButton::focusOutEvent(e);
+    if (!underMouse()) animateGlowTo(0.0);
+}
+
+void RetroButton::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    QColor bg = mix(QColor("#222222"), QColor("#333333"), glowLevel);
+    if (isDown()) bg = bg.darker(130);
+
+    p.setPen(QPen(mix(QColor("#555555"), QColor("#FFD54F"), glowLevel), 2));
+    p.setBrush(bg);
+    p.drawRoundedRect(QRectF(rect()).adjusted(1, 1, -1, -1), 6, 6);
+
+    p.setFont(font());
+    p.setPen(mix(QColor("#CCCCCC"), QColor("#FFFFFF"), glowLevel));
+    p.drawText(rect(), Qt::AlignCenter, text());
+}
@@ -0,0 +1,75 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// ==============================
+// 🔁 LOCK-FREE SPSC RING BUFFER
+// ==============================
+
+// Bounded single-producer/single-consumer queue. One thread may call the
+// write side (write/push), one other thread the read side (read/pop);
+// neither ever blocks or allocates after construction. Capacity is
+// rounded up to a power of two.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t minCapacity)
+    {
+        std::size_t cap = 1;
+        while (cap < minCapacity) cap <<= 1;
+        buf.resize(cap);
+        mask = cap - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    std::size_t capacity() const { return buf.size(); }
+
+    // Snapshot; exact only when called from one of the two sides.
+    std::size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    std::size_t freeSpace() const { return capacity() - size(); }
+
+    // ---- producer side ----
+    std::size_t write(const T *src, std::size_t n)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t t = tail.load(std::memory_order_acquire);
+        if (n > capacity() - (h - t)) n = capacity() - (h - t);
+        for (std::size_t i = 0; i < n; ++i)
+            buf[(h + i) & mask] = src[i];
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    bool push(const T &value) { return write(&value, 1) == 1; }
+
+    // ---- consumer side ----
+    std::size_t read(T *dst, std::size_t n)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        if (n > h - t) n = h - t;
+        for (std::size_t i = 0; i < n; ++i)
+            dst[i] = buf[(t + i) & mask];
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    bool pop(T &value) { return read(&value, 1) == 1; }
+
+private:
+    std::vector<T> buf;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> head{0};   // next slot to write
+    alignas(64) std::atomic<std::size_t> tail{0};   // next slot to read
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,53 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// ==============================
+// 🔺 LOCK-FREE TRIPLE BUFFER
+// ==============================
+
+// Latest-value handoff between one writer and one reader thread. The
+// writer fills its back slot and publishes it; the reader picks up the
+// newest published slot whenever it likes. Neither side ever waits, the
+// writer never overwrites what the reader is looking at, and frames the
+// reader was too slow for are simply skipped.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // ---- writer side ----
+    T &writeSlot() { return slots[back]; }
+
+    void publish()
+    {
+        back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // ---- reader side ----
+    // Swaps in the newest published value; false if nothing new arrived.
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+
+    const T &read() const { return slots[front]; }
+
+private:
+    static constexpr int kIndex = 3;
+    static constexpr int kFresh = 4;
+
+    T slots[3];
+    int back = 0;                      // writer only
+    int front = 1;                     // reader only
+    std::atomic<int> middle{2};        // slot index | kFresh
+};
+
+#endif // TRIPLEBUFFER_H
@@ -1,17 +1,76 @@
 QT += core gui
 QT += multimedia multimediawidgets
+QT += concurrent
 
 
 greaterThan(QT_MAJOR_VERSION,4) : QT += widgets
+win32: LIBS += -lpsapi
+
+# builtinlevels.cpp bakes the built-in levels at compile time
+msvc: QMAKE_CXXFLAGS += /constexpr:steps10000000
+clang: QMAKE_CXXFLAGS += -fconstexpr-steps=10000000
 
 SOURCES += \
+    assetpack.cpp \
+    audiomixer.cpp \
+    builtinlevels.cpp \
+    chunkedworld.cpp \
+    chipsynth.cpp \
+    crtfilter.cpp \
+    framerenderer.cpp \
+    framescheduler.cpp \
+    gamehud.cpp \
+    gamesimulation.cpp \
+    levelcache.cpp \
+    levelcompiler.cpp \
+    levellibrary.cpp \
+    levelpack.cpp \
     main.cpp \
     mainwindow.cpp \
-    my_label.cpp
+    mazegenerator.cpp \
+    mazerouter.cpp \
+    my_label.cpp \
+    pixelfont.cpp \
+    renderthread.cpp \
+    retrowidgets.cpp
 
 HEADERS += \
+    assetpack.h \
+    audiomixer.h \
+    builtinlevels.h \
+    chunkedworld.h \
+    chipsynth.h \
+    crtfilter.h \
+    framerenderer.h \
+    framescheduler.h \
+    gamehud.h \
+    gamesimulation.h \
+    gametypes.h \
+    levelcache.h \
+    levelcompiler.h \
+    levellibrary.h \
+    levelpack.h \
     mainwindow.h \
-    my_label.h
+    mazegenerator.h \
+    mazerouter.h \
+    my_label.h \
+    pixelfont.h \
+    renderthread.h \
+    retrowidgets.h \
+    spscring.h \
+    triplebuffer.h
+
+# Pre-converted assets. Build tools/assetpack into tools/assetpack/build
+# once, then `make assets` drops assets.pak next to the game; without it
+# everything is generated at startup as before.
+win32:CONFIG(debug, debug|release): PAK_DIR = $$OUT_PWD/debug
+else:win32: PAK_DIR = $$OUT_PWD/release
+else: PAK_DIR = $$OUT_PWD
+ASSETPACK = $$shell_path($$clean_path($$PWD/../tools/assetpack/build/assetpack))
+assets.commands = $$ASSETPACK $$shell_path($$PAK_DIR/assets.pak)
 
-RESOURCES += \
-    resources.qrc
+# Same for levels.pak from tools/levelpack; the built-in levels are the
+# fallback when it is missing.
+LEVELPACK = $$shell_path($$clean_path($$PWD/../tools/levelpack/build/levelpack))
+levels.commands = $$LEVELPACK $$shell_path($$PAK_DIR/levels.pak)
+QMAKE_EXTRA_TARGETS += assets levels